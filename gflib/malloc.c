@@ -1,7 +1,8 @@
 #include "global.h"
+#include "malloc.h"
 
 static void *sHeapStart;
-static u32 sHeapSize;
+static struct HeapControl *sHeapControl;
 
 #define MALLOC_SYSTEM_ID 0xA3A3
 
@@ -21,10 +22,58 @@ struct MemBlock {
     // Next block pointer. Equals sHeapStart if this is the last block.
     struct MemBlock *next;
 
+#ifndef NDEBUG
+    // Return address of the Alloc call that handed out this block.
+    void *callsite;
+#endif
+
     // Data in the memory block. (Arrays of length 0 are a GNU extension.)
     u8 data[0];
 };
 
+// Free blocks are kept in size-segregated lists, linked through their (unused)
+// data. Sizes below SMALL_BIN_LIMIT get one list per 4-byte size class, so a
+// small allocation is a pop from the front of its list. Larger sizes share a
+// list per power of two, which is searched first-fit.
+struct FreeLinks {
+    struct MemBlock *prev;
+    struct MemBlock *next;
+};
+
+#define MIN_BLOCK_SIZE sizeof(struct FreeLinks)
+
+#define SMALL_BIN_LIMIT 256
+#define NUM_SMALL_BINS (SMALL_BIN_LIMIT / 4)
+#define NUM_LARGE_BINS 10 // 256 up to HEAP_SIZE
+#define NUM_FREE_BINS (NUM_SMALL_BINS + NUM_LARGE_BINS)
+#define FREE_BIN_MASK_WORDS ((NUM_FREE_BINS + 31) / 32)
+
+#ifndef NDEBUG
+#define MAX_HEAP_CALLSITES 32
+
+struct HeapCallsite {
+    void *callsite;
+    u32 liveBytes;
+    u16 liveBlocks;
+    u16 totalAllocs;
+};
+#endif
+
+// Allocator bookkeeping. It lives at the start of the heap, ahead of the first
+// block, so that InitHeap resets it along with the blocks.
+struct HeapControl {
+    struct MemBlock *freeBins[NUM_FREE_BINS];
+    u32 freeBinMask[FREE_BIN_MASK_WORDS];
+    u32 heapSize;
+#ifndef NDEBUG
+    u32 usedBytes;
+    u32 peakUsedBytes;
+    struct HeapCallsite callsites[MAX_HEAP_CALLSITES];
+#endif
+};
+
+#define FREE_LINKS(block) ((struct FreeLinks *)(block)->data)
+
 void PutMemBlockHeader(void *block, struct MemBlock *prev, struct MemBlock *next, u32 size)
 {
     struct MemBlock *header = (struct MemBlock *)block;
@@ -41,10 +90,162 @@ void PutFirstMemBlockHeader(void *block, u32 size)
     PutMemBlockHeader(block, (struct MemBlock *)block, (struct MemBlock *)block, size - sizeof(struct MemBlock));
 }
 
+static u32 GetFreeBin(u32 size)
+{
+    u32 bin;
+
+    if (size < SMALL_BIN_LIMIT)
+        return size / 4;
+
+    bin = NUM_SMALL_BINS;
+    size /= SMALL_BIN_LIMIT * 2;
+    while (size != 0 && bin < NUM_FREE_BINS - 1)
+    {
+        size >>= 1;
+        bin++;
+    }
+    return bin;
+}
+
+static void InsertFreeBlock(struct MemBlock *block)
+{
+    u32 bin = GetFreeBin(block->size);
+    struct MemBlock *first = sHeapControl->freeBins[bin];
+
+    FREE_LINKS(block)->prev = NULL;
+    FREE_LINKS(block)->next = first;
+    if (first != NULL)
+        FREE_LINKS(first)->prev = block;
+
+    sHeapControl->freeBins[bin] = block;
+    sHeapControl->freeBinMask[bin / 32] |= 1u << (bin % 32);
+}
+
+static void RemoveFreeBlock(struct MemBlock *block)
+{
+    struct MemBlock *prev = FREE_LINKS(block)->prev;
+    struct MemBlock *next = FREE_LINKS(block)->next;
+    u32 bin;
+
+    if (next != NULL)
+        FREE_LINKS(next)->prev = prev;
+
+    if (prev != NULL)
+    {
+        FREE_LINKS(prev)->next = next;
+    }
+    else
+    {
+        bin = GetFreeBin(block->size);
+        sHeapControl->freeBins[bin] = next;
+        if (next == NULL)
+            sHeapControl->freeBinMask[bin / 32] &= ~(1u << (bin % 32));
+    }
+}
+
+// Returns the first non-empty bin at or after the given one, or NUM_FREE_BINS.
+static u32 FindNonEmptyBin(u32 bin)
+{
+    u32 word;
+    u32 bits;
+
+    if (bin >= NUM_FREE_BINS)
+        return NUM_FREE_BINS;
+
+    word = bin / 32;
+    bits = sHeapControl->freeBinMask[word] & (0xFFFFFFFF << (bin % 32));
+
+    while (bits == 0)
+    {
+        if (++word >= FREE_BIN_MASK_WORDS)
+            return NUM_FREE_BINS;
+        bits = sHeapControl->freeBinMask[word];
+    }
+
+    bin = word * 32;
+    while (!(bits & 0xFF))
+    {
+        bits >>= 8;
+        bin += 8;
+    }
+    while (!(bits & 1))
+    {
+        bits >>= 1;
+        bin++;
+    }
+    return bin;
+}
+
+static struct MemBlock *FindFreeBlock(u32 size)
+{
+    struct MemBlock *pos;
+    u32 bin = GetFreeBin(size);
+
+    // Every block in a small bin has exactly that bin's size, and every block
+    // in a later bin is bigger than the request, so only the request's own
+    // large bin needs searching.
+    if (bin >= NUM_SMALL_BINS)
+    {
+        for (pos = sHeapControl->freeBins[bin]; pos != NULL; pos = FREE_LINKS(pos)->next)
+        {
+            if (pos->size >= size)
+                return pos;
+        }
+        bin++;
+    }
+
+    bin = FindNonEmptyBin(bin);
+    if (bin >= NUM_FREE_BINS)
+        return NULL;
+
+    return sHeapControl->freeBins[bin];
+}
+
+#ifndef NDEBUG
+static void TrackCallsite(void *mem, void *callsite)
+{
+    struct MemBlock *block = (struct MemBlock *)((u8 *)mem - sizeof(struct MemBlock));
+    struct HeapCallsite *entry;
+    u32 i;
+
+    for (i = 0; i < MAX_HEAP_CALLSITES; i++)
+    {
+        entry = &sHeapControl->callsites[i];
+        if (entry->callsite == callsite || entry->callsite == NULL)
+        {
+            block->callsite = callsite;
+            entry->callsite = callsite;
+            entry->liveBytes += block->size;
+            entry->liveBlocks++;
+            entry->totalAllocs++;
+            break;
+        }
+    }
+}
+
+static void UntrackCallsite(struct MemBlock *block)
+{
+    u32 i;
+
+    if (block->callsite == NULL)
+        return;
+
+    for (i = 0; i < MAX_HEAP_CALLSITES; i++)
+    {
+        if (sHeapControl->callsites[i].callsite == block->callsite)
+        {
+            sHeapControl->callsites[i].liveBytes -= block->size;
+            sHeapControl->callsites[i].liveBlocks--;
+            break;
+        }
+    }
+}
+#endif
+
 void *AllocInternal(void *heapStart, u32 size)
 {
-    struct MemBlock *pos = (struct MemBlock *)heapStart;
-    struct MemBlock *head = pos;
+    struct MemBlock *head = (struct MemBlock *)heapStart;
+    struct MemBlock *pos;
     struct MemBlock *splitBlock;
     u32 foundBlockSize;
 
@@ -52,45 +253,49 @@ void *AllocInternal(void *heapStart, u32 size)
     if (size & 3)
         size = 4 * ((size / 4) + 1);
 
-    for (;;) {
-        // Loop through the blocks looking for unused block that's big enough.
+    // Free blocks need room for their list links.
+    if (size < MIN_BLOCK_SIZE)
+        size = MIN_BLOCK_SIZE;
 
-        if (!pos->flag) {
-            foundBlockSize = pos->size;
+    pos = FindFreeBlock(size);
+    if (pos == NULL)
+        return NULL;
 
-            if (foundBlockSize >= size) {
-                if (foundBlockSize - size < 2 * sizeof(struct MemBlock)) {
-                    // The block isn't much bigger than the requested size,
-                    // so just use it.
-                    pos->flag = TRUE;
-                } else {
-                    // The block is significantly bigger than the requested
-                    // size, so split the rest into a separate block.
-                    foundBlockSize -= sizeof(struct MemBlock);
-                    foundBlockSize -= size;
+    RemoveFreeBlock(pos);
+    foundBlockSize = pos->size;
 
-                    splitBlock = (struct MemBlock *)(pos->data + size);
+    if (foundBlockSize - size < 2 * sizeof(struct MemBlock)) {
+        // The block isn't much bigger than the requested size,
+        // so just use it.
+        pos->flag = TRUE;
+    } else {
+        // The block is significantly bigger than the requested
+        // size, so split the rest into a separate block.
+        foundBlockSize -= sizeof(struct MemBlock);
+        foundBlockSize -= size;
 
-                    pos->flag = TRUE;
-                    pos->size = size;
+        splitBlock = (struct MemBlock *)(pos->data + size);
 
-                    PutMemBlockHeader(splitBlock, pos, pos->next, foundBlockSize);
+        pos->flag = TRUE;
+        pos->size = size;
 
-                    pos->next = splitBlock;
+        PutMemBlockHeader(splitBlock, pos, pos->next, foundBlockSize);
 
-                    if (splitBlock->next != head)
-                        splitBlock->next->prev = splitBlock;
-                }
-
-                return pos->data;
-            }
-        }
+        pos->next = splitBlock;
 
-        if (pos->next == head)
-            return NULL;
+        if (splitBlock->next != head)
+            splitBlock->next->prev = splitBlock;
 
-        pos = pos->next;
+        InsertFreeBlock(splitBlock);
     }
+
+#ifndef NDEBUG
+    pos->callsite = NULL;
+    sHeapControl->usedBytes += pos->size + sizeof(struct MemBlock);
+    if (sHeapControl->usedBytes > sHeapControl->peakUsedBytes)
+        sHeapControl->peakUsedBytes = sHeapControl->usedBytes;
+#endif
+    return pos->data;
 }
 
 void FreeInternal(void *heapStart, void *pointer)
@@ -98,12 +303,18 @@ void FreeInternal(void *heapStart, void *pointer)
     if (pointer) {
         struct MemBlock *head = (struct MemBlock *)heapStart;
         struct MemBlock *block = (struct MemBlock *)((u8 *)pointer - sizeof(struct MemBlock));
+
+#ifndef NDEBUG
+        UntrackCallsite(block);
+        sHeapControl->usedBytes -= block->size + sizeof(struct MemBlock);
+#endif
         block->flag = FALSE;
 
         // If the freed block isn't the last one, merge with the next block
         // if it's not in use.
         if (block->next != head) {
             if (!block->next->flag) {
+                RemoveFreeBlock(block->next);
                 block->size += sizeof(struct MemBlock) + block->next->size;
                 block->next->magic = 0;
                 block->next = block->next->next;
@@ -116,6 +327,7 @@ void FreeInternal(void *heapStart, void *pointer)
         // if it's not in use.
         if (block != head) {
             if (!block->prev->flag) {
+                RemoveFreeBlock(block->prev);
                 block->prev->next = block->next;
 
                 if (block->next != head)
@@ -123,8 +335,11 @@ void FreeInternal(void *heapStart, void *pointer)
 
                 block->magic = 0;
                 block->prev->size += sizeof(struct MemBlock) + block->size;
+                block = block->prev;
             }
         }
+
+        InsertFreeBlock(block);
     }
 }
 
@@ -170,19 +385,37 @@ bool32 CheckMemBlockInternal(void *heapStart, void *pointer)
 
 void InitHeap(void *heapStart, u32 heapSize)
 {
-    sHeapStart = heapStart;
-    sHeapSize = heapSize;
-    PutFirstMemBlockHeader(heapStart, heapSize);
+    u32 controlSize = (sizeof(struct HeapControl) + 3) & ~3;
+
+    sHeapControl = (struct HeapControl *)heapStart;
+    CpuFill32(0, sHeapControl, controlSize);
+    sHeapControl->heapSize = heapSize;
+
+    sHeapStart = (u8 *)heapStart + controlSize;
+    PutFirstMemBlockHeader(sHeapStart, heapSize - controlSize);
+    InsertFreeBlock((struct MemBlock *)sHeapStart);
 }
 
 void *Alloc(u32 size)
 {
-    return AllocInternal(sHeapStart, size);
+    void *mem = AllocInternal(sHeapStart, size);
+
+#ifndef NDEBUG
+    if (mem != NULL)
+        TrackCallsite(mem, __builtin_return_address(0));
+#endif
+    return mem;
 }
 
 void *AllocZeroed(u32 size)
 {
-    return AllocZeroedInternal(sHeapStart, size);
+    void *mem = AllocZeroedInternal(sHeapStart, size);
+
+#ifndef NDEBUG
+    if (mem != NULL)
+        TrackCallsite(mem, __builtin_return_address(0));
+#endif
+    return mem;
 }
 
 void Free(void *pointer)
@@ -207,3 +440,60 @@ bool32 CheckHeap()
 
     return TRUE;
 }
+
+#ifndef NDEBUG
+void GetHeapStats(struct HeapStats *stats)
+{
+    struct MemBlock *pos = (struct MemBlock *)sHeapStart;
+
+    stats->heapSize = sHeapControl->heapSize;
+    stats->usedBytes = sHeapControl->usedBytes;
+    stats->peakUsedBytes = sHeapControl->peakUsedBytes;
+    stats->freeBytes = 0;
+    stats->largestFreeBlock = 0;
+    stats->usedBlocks = 0;
+    stats->freeBlocks = 0;
+
+    do {
+        if (pos->flag)
+        {
+            stats->usedBlocks++;
+        }
+        else
+        {
+            stats->freeBlocks++;
+            stats->freeBytes += pos->size;
+            if (pos->size > stats->largestFreeBlock)
+                stats->largestFreeBlock = pos->size;
+        }
+        pos = pos->next;
+    } while (pos != (struct MemBlock *)sHeapStart);
+
+    // How much of the free memory is outside the largest free block.
+    if (stats->freeBytes != 0)
+        stats->fragmentation = 100 - (stats->largestFreeBlock * 100) / stats->freeBytes;
+    else
+        stats->fragmentation = 0;
+}
+
+void DebugPrintHeapStats(void)
+{
+    struct HeapStats stats;
+    struct HeapCallsite *entry;
+    u32 i;
+
+    GetHeapStats(&stats);
+    DebugPrintf("Heap: used %d peak %d of %d", stats.usedBytes, stats.peakUsedBytes, stats.heapSize);
+    DebugPrintf("Heap: %d used blocks, %d free blocks", stats.usedBlocks, stats.freeBlocks);
+    DebugPrintf("Heap: free %d largest %d fragmentation %d%%", stats.freeBytes, stats.largestFreeBlock, stats.fragmentation);
+
+    for (i = 0; i < MAX_HEAP_CALLSITES; i++)
+    {
+        entry = &sHeapControl->callsites[i];
+        if (entry->callsite == NULL)
+            break;
+        if (entry->liveBlocks != 0)
+            DebugPrintf("  0x%x: %d bytes in %d blocks (%d allocs)", (u32)entry->callsite, entry->liveBytes, entry->liveBlocks, entry->totalAllocs);
+    }
+}
+#endif
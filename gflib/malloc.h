@@ -21,4 +21,21 @@ void *AllocZeroed(u32 size);
 void Free(void *pointer);
 void InitHeap(void *pointer, u32 size);
 
+#ifndef NDEBUG
+struct HeapStats
+{
+    u32 heapSize;
+    u32 usedBytes; // Including block headers
+    u32 peakUsedBytes;
+    u32 freeBytes;
+    u32 largestFreeBlock;
+    u16 usedBlocks;
+    u16 freeBlocks;
+    u8 fragmentation; // Percentage of free memory outside the largest free block
+};
+
+void GetHeapStats(struct HeapStats *stats);
+void DebugPrintHeapStats(void);
+#endif
+
 #endif // GUARD_ALLOC_H
@@ -4,6 +4,7 @@
 #include "palette.h"
 
 #include "rogue_controller.h"
+#include "rogue_profiler.h"
 
 #define MAX_SPRITE_COPY_REQUESTS 64
 
@@ -51,7 +52,7 @@ struct OamDimensions
 };
 
 static void UpdateOamCoords(void);
-static void BuildSpritePriorities(void);
+static void BuildSpriteSortKeys(void);
 static void SortSprites(void);
 static void CopyMatricesToOamBuffer(void);
 static void AddSpritesToOamBuffer(void);
@@ -281,7 +282,7 @@ u32 gOamMatrixAllocBitmap;
 u8 gReservedSpritePaletteCount;
 
 EWRAM_DATA struct Sprite gSprites[MAX_SPRITES + 1] = {0};
-EWRAM_DATA static u16 sSpritePriorities[MAX_SPRITES] = {0};
+EWRAM_DATA static u32 sSpriteSortKeys[MAX_SPRITES] = {0};
 EWRAM_DATA static u8 sSpriteOrder[MAX_SPRITES] = {0};
 EWRAM_DATA static bool8 sShouldProcessSpriteCopyRequests = 0;
 EWRAM_DATA static u8 sSpriteCopyRequestCount = 0;
@@ -311,6 +312,9 @@ void ResetSpriteData(void)
 void AnimateSprites(void)
 {
     u8 i;
+
+    PROFILE_BEGIN(PROFILE_SECTION_ANIMATE_SPRITES);
+
     for (i = 0; i < MAX_SPRITES; i++)
     {
         struct Sprite *sprite = &gSprites[i];
@@ -323,13 +327,16 @@ void AnimateSprites(void)
                 AnimateSprite(sprite);
         }
     }
+
+    PROFILE_END(PROFILE_SECTION_ANIMATE_SPRITES);
 }
 
 void BuildOamBuffer(void)
 {
     u8 temp;
+    PROFILE_BEGIN(PROFILE_SECTION_BUILD_OAM);
     UpdateOamCoords();
-    BuildSpritePriorities();
+    BuildSpriteSortKeys();
     SortSprites();
     temp = gMain.oamLoadDisabled;
     gMain.oamLoadDisabled = TRUE;
@@ -337,6 +344,7 @@ void BuildOamBuffer(void)
     CopyMatricesToOamBuffer();
     gMain.oamLoadDisabled = temp;
     sShouldProcessSpriteCopyRequests = TRUE;
+    PROFILE_END(PROFILE_SECTION_BUILD_OAM);
 }
 
 void UpdateOamCoords(void)
@@ -361,111 +369,61 @@ void UpdateOamCoords(void)
     }
 }
 
-void BuildSpritePriorities(void)
+// Sprites are drawn in ascending order of this key: oam priority, then
+// subpriority, then from the bottom of the screen up. Y is adjusted for
+// sprites that wrap around from the bottom of the screen.
+void BuildSpriteSortKeys(void)
 {
     u16 i;
     for (i = 0; i < MAX_SPRITES; i++)
     {
         struct Sprite *sprite = &gSprites[i];
         u16 priority = sprite->subpriority | (sprite->oam.priority << 8);
-        sSpritePriorities[i] = priority;
-    }
-}
+        s16 y = sprite->oam.y;
 
-void SortSprites(void)
-{
-    u8 i;
-    for (i = 1; i < MAX_SPRITES; i++)
-    {
-        u8 j = i;
-        struct Sprite *sprite1 = &gSprites[sSpriteOrder[i - 1]];
-        struct Sprite *sprite2 = &gSprites[sSpriteOrder[i]];
-        u16 sprite1Priority = sSpritePriorities[sSpriteOrder[i - 1]];
-        u16 sprite2Priority = sSpritePriorities[sSpriteOrder[i]];
-        s16 sprite1Y = sprite1->oam.y;
-        s16 sprite2Y = sprite2->oam.y;
-
-        if (sprite1Y >= DISPLAY_HEIGHT)
-            sprite1Y = sprite1Y - 256;
-
-        if (sprite2Y >= DISPLAY_HEIGHT)
-            sprite2Y = sprite2Y - 256;
-
-        if (sprite1->oam.affineMode == ST_OAM_AFFINE_DOUBLE
-         && sprite1->oam.size == ST_OAM_SIZE_3)
-        {
-            u32 shape = sprite1->oam.shape;
-            if (shape == ST_OAM_SQUARE || shape == ST_OAM_V_RECTANGLE)
-            {
-                if (sprite1Y > 128)
-                    sprite1Y = sprite1Y - 256;
-            }
-        }
+        if (y >= DISPLAY_HEIGHT)
+            y = y - 256;
 
-        if (sprite2->oam.affineMode == ST_OAM_AFFINE_DOUBLE
-         && sprite2->oam.size == ST_OAM_SIZE_3)
+        if (sprite->oam.affineMode == ST_OAM_AFFINE_DOUBLE
+         && sprite->oam.size == ST_OAM_SIZE_3)
         {
-            u32 shape = sprite2->oam.shape;
+            u32 shape = sprite->oam.shape;
             if (shape == ST_OAM_SQUARE || shape == ST_OAM_V_RECTANGLE)
             {
-                if (sprite2Y > 128)
-                    sprite2Y = sprite2Y - 256;
+                if (y > 128)
+                    y = y - 256;
             }
         }
 
-        while (j > 0
-            && ((sprite1Priority > sprite2Priority)
-             || (sprite1Priority == sprite2Priority && sprite1Y < sprite2Y)))
-        {
-            u8 temp = sSpriteOrder[j];
-            sSpriteOrder[j] = sSpriteOrder[j - 1];
-            sSpriteOrder[j - 1] = temp;
-
-            // UB: If j equals 1, then j-- makes j equal 0.
-            // Then, sSpriteOrder[-1] gets accessed below.
-            // Although this doesn't result in a bug in the ROM,
-            // the behavior is undefined.
-            j--;
-#ifdef UBFIX
-            if (j == 0)
-                break;
-#endif
+        sSpriteSortKeys[i] = (priority << 9) | (DISPLAY_HEIGHT - 1 - y);
+    }
+}
 
-            sprite1 = &gSprites[sSpriteOrder[j - 1]];
-            sprite2 = &gSprites[sSpriteOrder[j]];
-            sprite1Priority = sSpritePriorities[sSpriteOrder[j - 1]];
-            sprite2Priority = sSpritePriorities[sSpriteOrder[j]];
-            sprite1Y = sprite1->oam.y;
-            sprite2Y = sprite2->oam.y;
+// Stable insertion sort starting from last frame's order, so sprites with
+// equal keys keep their relative order. The order rarely changes much
+// between frames, so this is usually a single pass.
+void SortSprites(void)
+{
+    u8 i, j;
+    u8 index;
+    u32 key;
 
-            if (sprite1Y >= DISPLAY_HEIGHT)
-                sprite1Y = sprite1Y - 256;
+    for (i = 1; i < MAX_SPRITES; i++)
+    {
+        index = sSpriteOrder[i];
+        key = sSpriteSortKeys[index];
 
-            if (sprite2Y >= DISPLAY_HEIGHT)
-                sprite2Y = sprite2Y - 256;
+        if (sSpriteSortKeys[sSpriteOrder[i - 1]] <= key)
+            continue;
 
-            if (sprite1->oam.affineMode == ST_OAM_AFFINE_DOUBLE
-             && sprite1->oam.size == ST_OAM_SIZE_3)
-            {
-                u32 shape = sprite1->oam.shape;
-                if (shape == ST_OAM_SQUARE || shape == ST_OAM_V_RECTANGLE)
-                {
-                    if (sprite1Y > 128)
-                        sprite1Y = sprite1Y - 256;
-                }
-            }
+        j = i;
+        do
+        {
+            sSpriteOrder[j] = sSpriteOrder[j - 1];
+            j--;
+        } while (j > 0 && sSpriteSortKeys[sSpriteOrder[j - 1]] > key);
 
-            if (sprite2->oam.affineMode == ST_OAM_AFFINE_DOUBLE
-             && sprite2->oam.size == ST_OAM_SIZE_3)
-            {
-                u32 shape = sprite2->oam.shape;
-                if (shape == ST_OAM_SQUARE || shape == ST_OAM_V_RECTANGLE)
-                {
-                    if (sprite2Y > 128)
-                        sprite2Y = sprite2Y - 256;
-                }
-            }
-        }
+        sSpriteOrder[j] = index;
     }
 }
 
@@ -35,8 +35,27 @@ static u32 GetGlyphWidth_Short(u16, bool32);
 static u32 GetGlyphWidth_Narrow(u16, bool32);
 static u32 GetGlyphWidth_SmallNarrow(u16, bool32);
 
+// Expanded glyphs, keyed by font, character and the text colors they were
+// expanded with, so reprinting the same strings skips decoding the font data.
+// Only glyphs at most one tile wide are cached, which is nearly all Latin text,
+// so each entry keeps just the left-hand column of gCurGlyph's 2x2 tiles.
+#define GLYPH_CACHE_SIZE 32
+
+struct CachedGlyph
+{
+    u32 rows[16];
+    u16 glyphId;
+    u16 colors;
+    u8 fontId;
+    u8 width;
+    u8 height;
+    u8 japanese:1;
+    u8 isValid:1;
+};
+
 static EWRAM_DATA struct TextPrinter sTempTextPrinter = {0};
 static EWRAM_DATA struct TextPrinter sTextPrinters[NUM_TEXT_PRINTERS] = {0};
+static EWRAM_DATA struct CachedGlyph sGlyphCache[GLYPH_CACHE_SIZE] = {0};
 
 static u16 sFontHalfRowLookupTable[0x51];
 static u16 sLastTextBgColor;
@@ -587,35 +606,47 @@ static u8 GetLastTextColor(u8 colorType)
     }
 }
 
-inline static void GLYPH_COPY(u8 *windowTiles, u32 widthOffset, u32 j, u32 i, u32 *glyphPixels, s32 width, s32 height)
+// Draws up to 8 columns of a glyph tile, one row at a time. Each glyph row is
+// eight 4bpp pixels in a word, so it is merged into the window a whole tile
+// row at a time. Zero pixels are transparent and leave the window untouched.
+inline static void GLYPH_COPY(u8 *windowTiles, u32 widthOffset, u32 x, u32 y, const u32 *glyphPixels, s32 width, s32 height)
 {
-    u32 xAdd, yAdd, pixelData, bits, toOrr, dummyX;
-    u8 *dst;
+    u32 pixels, opaque, columnMask, shift;
+    u32 *dst;
+    u8 *tileColumn;
+
+    if (width <= 0 || height <= 0)
+        return;
 
-    xAdd = j + width;
-    yAdd = i + height;
-    dummyX = j;
-    for (; i < yAdd; i++)
+    columnMask = (width >= 8) ? 0xFFFFFFFF : ((1 << (width * 4)) - 1);
+    shift = (x % 8) * 4;
+    tileColumn = windowTiles + (x / 8) * 32;
+
+    for (; height > 0; height--, y++)
     {
-        pixelData = *glyphPixels++;
-        for (j = dummyX; j < xAdd; j++)
-        {
-            if ((toOrr = pixelData & 0xF))
-            {
-                dst = windowTiles + ((j / 8) * 32) + ((j % 8) / 2) + ((i / 8) * widthOffset) + ((i % 8) * 4);
-                bits = ((j & 1) * 4);
-                *dst = (toOrr << bits) | (*dst & (0xF0 >> bits));
-            }
-            pixelData >>= 4;
-        }
+        pixels = *glyphPixels++ & columnMask;
+
+        opaque = pixels | (pixels >> 1);
+        opaque |= opaque >> 2;
+        opaque = (opaque & 0x11111111) * 0xF;
+        if (opaque == 0)
+            continue;
+
+        dst = (u32 *)(tileColumn + ((y / 8) * widthOffset) + ((y % 8) * 4));
+        dst[0] = (dst[0] & ~(opaque << shift)) | (pixels << shift);
+
+        // The rest of the row spills into the next tile along
+        if (shift != 0 && (opaque >> (32 - shift)) != 0)
+            dst[8] = (dst[8] & ~(opaque >> (32 - shift))) | (pixels >> (32 - shift));
     }
 }
 
-void CopyGlyphToWindow(struct TextPrinter *textPrinter)
+// topRows and bottomRows are the glyph's top and bottom tile rows. For glyphs
+// wider than a tile the right-hand tiles follow 8 words after each.
+static void CopyGlyphPixelsToWindow(struct TextPrinter *textPrinter, const u32 *topRows, const u32 *bottomRows, u32 width, u32 height)
 {
     struct Window *window;
     struct WindowTemplate *template;
-    u32 *glyphPixels;
     u32 currX, currY, widthOffset;
     s32 glyphWidth, glyphHeight;
     u8 *windowTiles;
@@ -623,15 +654,14 @@ void CopyGlyphToWindow(struct TextPrinter *textPrinter)
     window = &gWindows[textPrinter->printerTemplate.windowId];
     template = &window->window;
 
-    if ((glyphWidth = (template->width * 8) - textPrinter->printerTemplate.currentX) > gCurGlyph.width)
-        glyphWidth = gCurGlyph.width;
+    if ((glyphWidth = (template->width * 8) - textPrinter->printerTemplate.currentX) > width)
+        glyphWidth = width;
 
-    if ((glyphHeight = (template->height * 8) - textPrinter->printerTemplate.currentY) > gCurGlyph.height)
-        glyphHeight = gCurGlyph.height;
+    if ((glyphHeight = (template->height * 8) - textPrinter->printerTemplate.currentY) > height)
+        glyphHeight = height;
 
     currX = textPrinter->printerTemplate.currentX;
     currY = textPrinter->printerTemplate.currentY;
-    glyphPixels = gCurGlyph.gfxBufferTop;
     windowTiles = window->tileData;
     widthOffset = template->width * 32;
 
@@ -639,31 +669,36 @@ void CopyGlyphToWindow(struct TextPrinter *textPrinter)
     {
         if (glyphHeight < 9)
         {
-            GLYPH_COPY(windowTiles, widthOffset, currX, currY, glyphPixels, glyphWidth, glyphHeight);
+            GLYPH_COPY(windowTiles, widthOffset, currX, currY, topRows, glyphWidth, glyphHeight);
         }
         else
         {
-            GLYPH_COPY(windowTiles, widthOffset, currX, currY, glyphPixels, glyphWidth, 8);
-            GLYPH_COPY(windowTiles, widthOffset, currX, currY + 8, glyphPixels + 16, glyphWidth, glyphHeight - 8);
+            GLYPH_COPY(windowTiles, widthOffset, currX, currY, topRows, glyphWidth, 8);
+            GLYPH_COPY(windowTiles, widthOffset, currX, currY + 8, bottomRows, glyphWidth, glyphHeight - 8);
         }
     }
     else
     {
         if (glyphHeight < 9)
         {
-            GLYPH_COPY(windowTiles, widthOffset, currX, currY, glyphPixels, 8, glyphHeight);
-            GLYPH_COPY(windowTiles, widthOffset, currX + 8, currY, glyphPixels + 8, glyphWidth - 8, glyphHeight);
+            GLYPH_COPY(windowTiles, widthOffset, currX, currY, topRows, 8, glyphHeight);
+            GLYPH_COPY(windowTiles, widthOffset, currX + 8, currY, topRows + 8, glyphWidth - 8, glyphHeight);
         }
         else
         {
-            GLYPH_COPY(windowTiles, widthOffset, currX, currY, glyphPixels, 8, 8);
-            GLYPH_COPY(windowTiles, widthOffset, currX + 8, currY, glyphPixels + 8, glyphWidth - 8, 8);
-            GLYPH_COPY(windowTiles, widthOffset, currX, currY + 8, glyphPixels + 16, 8, glyphHeight - 8);
-            GLYPH_COPY(windowTiles, widthOffset, currX + 8, currY + 8, glyphPixels + 24, glyphWidth - 8, glyphHeight - 8);
+            GLYPH_COPY(windowTiles, widthOffset, currX, currY, topRows, 8, 8);
+            GLYPH_COPY(windowTiles, widthOffset, currX + 8, currY, topRows + 8, glyphWidth - 8, 8);
+            GLYPH_COPY(windowTiles, widthOffset, currX, currY + 8, bottomRows, 8, glyphHeight - 8);
+            GLYPH_COPY(windowTiles, widthOffset, currX + 8, currY + 8, bottomRows + 8, glyphWidth - 8, glyphHeight - 8);
         }
     }
 }
 
+void CopyGlyphToWindow(struct TextPrinter *textPrinter)
+{
+    CopyGlyphPixelsToWindow(textPrinter, gCurGlyph.gfxBufferTop, gCurGlyph.gfxBufferBottom, gCurGlyph.width, gCurGlyph.height);
+}
+
 void ClearTextSpan(struct TextPrinter *textPrinter, u32 width)
 {
     struct Window *window;
@@ -951,6 +986,76 @@ void DrawDownArrow(u8 windowId, u16 x, u16 y, u8 bgColor, bool8 drawArrow, u8 *c
     }
 }
 
+static void DecompressGlyph(u16 glyphId, u8 fontId, bool32 isJapanese)
+{
+    switch (fontId)
+    {
+    case FONT_SMALL:
+        DecompressGlyph_Small(glyphId, isJapanese);
+        break;
+    case FONT_NORMAL:
+        DecompressGlyph_Normal(glyphId, isJapanese);
+        break;
+    case FONT_SHORT:
+    case FONT_SHORT_COPY_1:
+    case FONT_SHORT_COPY_2:
+    case FONT_SHORT_COPY_3:
+        DecompressGlyph_Short(glyphId, isJapanese);
+        break;
+    case FONT_NARROW:
+        DecompressGlyph_Narrow(glyphId, isJapanese);
+        break;
+    case FONT_SMALL_NARROW:
+        DecompressGlyph_SmallNarrow(glyphId, isJapanese);
+        break;
+    case FONT_BRAILLE:
+        break;
+    }
+}
+
+// Draws the glyph in the current text colors. gCurGlyph's width and height are
+// always updated, but its pixels are only filled on a cache miss.
+static void DrawGlyph(struct TextPrinter *textPrinter, u16 glyphId, u8 fontId, bool32 isJapanese)
+{
+    struct CachedGlyph *entry;
+    u16 colors;
+
+    if (fontId == FONT_BRAILLE)
+    {
+        CopyGlyphToWindow(textPrinter);
+        return;
+    }
+
+    colors = sLastTextFgColor | (sLastTextBgColor << 4) | (sLastTextShadowColor << 8);
+    entry = &sGlyphCache[(glyphId + fontId * 16) % GLYPH_CACHE_SIZE];
+
+    if (entry->isValid && entry->glyphId == glyphId && entry->fontId == fontId && entry->japanese == (isJapanese != FALSE) && entry->colors == colors)
+    {
+        gCurGlyph.width = entry->width;
+        gCurGlyph.height = entry->height;
+        CopyGlyphPixelsToWindow(textPrinter, entry->rows, entry->rows + 8, entry->width, entry->height);
+        return;
+    }
+
+    DecompressGlyph(glyphId, fontId, isJapanese);
+
+    // Wide glyphs are drawn straight from gCurGlyph and leave the entry alone
+    if (gCurGlyph.width <= 8)
+    {
+        CpuCopy32(gCurGlyph.gfxBufferTop, entry->rows, 8 * sizeof(u32));
+        CpuCopy32(gCurGlyph.gfxBufferBottom, entry->rows + 8, 8 * sizeof(u32));
+        entry->glyphId = glyphId;
+        entry->colors = colors;
+        entry->fontId = fontId;
+        entry->width = gCurGlyph.width;
+        entry->height = gCurGlyph.height;
+        entry->japanese = (isJapanese != FALSE);
+        entry->isValid = TRUE;
+    }
+
+    CopyGlyphToWindow(textPrinter);
+}
+
 static u16 RenderText(struct TextPrinter *textPrinter)
 {
     struct TextPrinterSubStruct *subStruct = (struct TextPrinterSubStruct *)(&textPrinter->subStructFields);
@@ -1157,31 +1262,7 @@ static u16 RenderText(struct TextPrinter *textPrinter)
             return RENDER_FINISH;
         }
 
-        switch (subStruct->fontId)
-        {
-        case FONT_SMALL:
-            DecompressGlyph_Small(currChar, textPrinter->japanese);
-            break;
-        case FONT_NORMAL:
-            DecompressGlyph_Normal(currChar, textPrinter->japanese);
-            break;
-        case FONT_SHORT:
-        case FONT_SHORT_COPY_1:
-        case FONT_SHORT_COPY_2:
-        case FONT_SHORT_COPY_3:
-            DecompressGlyph_Short(currChar, textPrinter->japanese);
-            break;
-        case FONT_NARROW:
-            DecompressGlyph_Narrow(currChar, textPrinter->japanese);
-            break;
-        case FONT_SMALL_NARROW:
-            DecompressGlyph_SmallNarrow(currChar, textPrinter->japanese);
-            break;
-        case FONT_BRAILLE:
-            break;
-        }
-
-        CopyGlyphToWindow(textPrinter);
+        DrawGlyph(textPrinter, currChar, subStruct->fontId, textPrinter->japanese);
 
         if (textPrinter->minLetterSpacing)
         {
@@ -5,6 +5,7 @@
 
 //#define ROGUE_FEATURE_AUTOMATION // Activate this for builds where automated external interactions are enabled (e.g. Soak Tests)
 //#define ROGUE_FEATURE_SKIP_SAVE_WARNINGS // Activate this if you intend on putting on a physical cart with 64k FLASH save
+//#define ROGUE_FEATURE_PROFILER // Activate this to time the main subsystems every frame (uses timer 2)
 
 
 #ifndef ROGUE_FEATURE_AUTOMATION
@@ -5,7 +5,10 @@
 
 extern u8 gDecompressionBuffer[0x4000];
 
+bool8 OpenDecompressionCache(void);
+void CloseDecompressionCache(void);
 void LZDecompressWram(const u32 *src, void *dest);
+void LZDecompressWramCached(const u32 *src, void *dest);
 void LZDecompressVram(const u32 *src, void *dest);
 
 u16 LoadCompressedSpriteSheet(const struct CompressedSpriteSheet *src);
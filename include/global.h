@@ -962,7 +962,7 @@ struct SaveBlock1
     /*0x9BC*/ u16 berryBlenderRecords[3];
               u16 rogueSaveVersion;
               u16 rogueCompatVersion;
-    /*0x9C2*/ u8 unused_9C2[2];
+              u16 rogueMigrationLevel;
     /*0x9C8*/ u16 trainerRematchStepCounter;
     /*0x9CA*/ u8 trainerRematches[MAX_REMATCH_ENTRIES];
     /*0xA30*/ struct ObjectEvent objectEvents[OBJECT_EVENTS_COUNT];
@@ -129,6 +129,7 @@ bool16 QuestMenuRunTextPrinters(void);
 void QuestMenuCreateYesNoMenu(void);
 u8 LoadQuestMenuMovesList(const struct ListMenuItem *items, u16 numChoices);
 void InitQuestMenuWindows(bool8 useContextWindow);
+void QuestMenuRefreshDetails(s32 itemIndex);
 
 // Level up window
 void DrawLevelUpWindowPg1(u16 windowId, u16 *statsBefore, u16 *statsAfter, u8 bgClr, u8 fgClr, u8 shadowClr);
@@ -55,6 +55,8 @@ extern u16 gPlttBufferFaded[PLTT_BUFFER_SIZE];
 void LoadCompressedPalette(const u32 *, u16, u16);
 void LoadPalette(const void *, u16, u16);
 void FillPalette(u16, u16, u16);
+void InitPaletteBlendCode(void);
+void BlendPaletteWordsRam(const u32 *src, u32 *dest, u32 numWords, u8 coeff, u16 blendColor);
 void TransferPlttBuffer(void);
 u8 UpdatePaletteFade(void);
 void ResetPaletteFade(void);
@@ -115,6 +115,15 @@ struct BoxPokemon
     } secure;
 };
 
+// A decrypted copy of a box mon, see OpenBoxMonView
+struct BoxMonView
+{
+    struct BoxPokemon *source;
+    struct BoxPokemon mon;
+    bool8 isValid;
+    bool8 isDirty;
+};
+
 struct Pokemon
 {
     struct BoxPokemon box;
@@ -352,6 +361,10 @@ u32 GetBoxMonData();
 
 void SetMonData(struct Pokemon *mon, s32 field, const void *dataArg);
 void SetBoxMonData(struct BoxPokemon *boxMon, s32 field, const void *dataArg);
+void OpenBoxMonView(struct BoxMonView *view, struct BoxPokemon *boxMon);
+u32 GetBoxMonViewData(struct BoxMonView *view, s32 field, u8 *data);
+void SetBoxMonViewData(struct BoxMonView *view, s32 field, const void *data);
+void CommitBoxMonView(struct BoxMonView *view);
 void CopyMon(void *dest, void *src, size_t size);
 u8 GiveMonToPlayer(struct Pokemon *mon);
 u8 CalculatePlayerPartyCount(void);
@@ -29,6 +29,22 @@ struct PokemonStorage
     /*0x83C2*/ u8 boxWallpapers[ACTUAL_TOTAL_BOXES_COUNT];
 };
 
+#define STORAGE_INDEX_VALID         (1 << 0)
+#define STORAGE_INDEX_HAS_SPECIES   (1 << 1)
+#define STORAGE_INDEX_IS_EGG        (1 << 2)
+#define STORAGE_INDEX_IS_BAD_EGG    (1 << 3)
+
+struct BoxMonView;
+
+struct StorageIndexEntry
+{
+    u32 personality;
+    u16 checksum;
+    u16 species;
+    u16 heldItem;
+    u8 flags;
+};
+
 extern struct PokemonStorage *gPokemonStoragePtr;
 
 void DrawTextWindowAndBufferTiles(const u8 *string, void *dst, u8 zero1, u8 zero2, s32 bytesToBuffer);
@@ -65,6 +81,12 @@ u32 CountAllStorageMons(void);
 bool32 AnyStorageMonWithMove(u16 moveId);
 bool8 AnyStorageMonOfSpecies(u16 species);
 bool8 AnyPlayerPartyMonOfSpecies(u16 species);
+void InvalidateStorageIndex(void);
+void InvalidateStorageIndexEntry(const struct BoxPokemon *boxMon);
+const struct StorageIndexEntry *GetStorageIndexEntry(u8 boxId, u8 boxPosition);
+u16 GetIndexedBoxMonSpecies(u8 boxId, u8 boxPosition);
+u16 GetIndexedBoxMonHeldItem(u8 boxId, u8 boxPosition);
+void ForEachStorageMon(void (*func)(struct BoxMonView *view, u8 boxId, u8 boxPosition));
 
 void ResetWaldaWallpaper(void);
 void SetWaldaWallpaperLockedOrUnlocked(bool32 unlocked);
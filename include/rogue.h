@@ -253,6 +253,8 @@ struct RogueAutomationHeader
 {
     u32 commBufferCapacity;
     u16* commBuffer;
+    u32 snapshotSize;
+    const void* snapshot;
 };
 
 extern const struct RogueAutomationHeader gRogueAutomationHeader;
@@ -0,0 +1,61 @@
+#ifndef ROGUE_PROFILER_H
+#define ROGUE_PROFILER_H
+
+enum
+{
+    PROFILE_SECTION_TASKS,
+    PROFILE_SECTION_ANIMATE_SPRITES,
+    PROFILE_SECTION_BUILD_OAM,
+    PROFILE_SECTION_PALETTE_FADE,
+    PROFILE_SECTION_SCRIPT,
+    PROFILE_SECTION_TRAINER_PARTY,
+    PROFILE_SECTION_ADVENTURE_PATHS,
+    PROFILE_SECTION_COUNT
+};
+
+#ifdef ROGUE_FEATURE_PROFILER
+
+// Times are measured with timer 2 running at 1/64 of the CPU clock.
+#define PROFILE_TICK_CYCLES 64
+#define PROFILE_FRAME_CYCLES 280896
+#define PROFILE_TRACE_CAPACITY 64
+
+struct RogueProfilerFrame
+{
+    u16 frameTicks;
+    u16 sectionTicks[PROFILE_SECTION_COUNT];
+};
+
+// Lets an emulator script find the trace. frames is a ring buffer, and the
+// most recent frame is at (*frameCount - 1) % frameCapacity.
+struct RogueProfilerHeader
+{
+    u32 frameCapacity;
+    u32 sectionCount;
+    u32 tickCycles;
+    const struct RogueProfilerFrame *frames;
+    const u32 *frameCount;
+};
+
+extern const struct RogueProfilerHeader gRogueProfilerHeader;
+
+void Rogue_ProfilerInit(void);
+void Rogue_ProfilerBeginFrame(void);
+void Rogue_ProfilerEndFrame(void);
+void Rogue_ProfilerBegin(u8 section);
+void Rogue_ProfilerEnd(u8 section);
+const struct RogueProfilerFrame *Rogue_ProfilerGetLastFrame(void);
+const struct RogueProfilerFrame *Rogue_ProfilerGetPeakFrame(void);
+void Rogue_ProfilerResetPeak(void);
+
+#define PROFILE_BEGIN(section) Rogue_ProfilerBegin(section)
+#define PROFILE_END(section) Rogue_ProfilerEnd(section)
+
+#else
+
+#define PROFILE_BEGIN(section)
+#define PROFILE_END(section)
+
+#endif
+
+#endif //ROGUE_PROFILER_H
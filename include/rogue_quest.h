@@ -3,6 +3,7 @@
 
 void ResetQuestStateAfter(u16 loadedQuestCapacity);
 void ResetQuestsFor_1_3_1(void);
+void InvalidateQuestMasks(void);
 bool8 AnyNewQuests(void);
 bool8 AnyQuestRewardsPending(void);
 bool8 AnyNewQuestsPending(void);
@@ -4,6 +4,7 @@
 typedef void (*RogueQuestMenuCallback)(void);
 
 bool8 Rogue_IsQuestMenuOverviewActive(void);
+bool8 Rogue_IsQuestMenuRewardsActive(void);
 
 void Rogue_OpenQuestMenu(RogueQuestMenuCallback callback);
 
@@ -78,6 +78,7 @@ struct SaveSector
 
 #define SECTOR_SECURITY_OFFSET offsetof(struct SaveSector, security)
 #define SECTOR_COUNTER_OFFSET offsetof(struct SaveSector, counter)
+#define SECTOR_FOOTER_ID_OFFSET offsetof(struct SaveSector, id)
 
 extern u16 gLastWrittenSector;
 extern u32 gLastSaveCounter;
@@ -92,6 +93,7 @@ extern struct SaveSectorLocation gRamSaveSectorLocations[];
 
 extern struct SaveSector gSaveDataBuffer;
 
+void InitSaveChecksumCode(void);
 void ClearSaveData(void);
 void Save_ResetSaveCounters(void);
 u8 HandleSavingData(u8 saveType);
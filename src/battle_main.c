@@ -66,6 +66,7 @@
 #include "rogue_charms.h"
 #include "rogue_controller.h"
 #include "rogue_popup.h"
+#include "rogue_profiler.h"
 
 extern const struct BgTemplate gBattleBgTemplates[];
 extern const struct WindowTemplate *const gBattleWindowTemplates[];
@@ -1989,6 +1990,8 @@ static u8 CreateNPCTrainerParty(struct Pokemon *party, u16 trainerNum, bool8 fir
         
         struct Trainer trainer;
 
+        PROFILE_BEGIN(PROFILE_SECTION_TRAINER_PARTY);
+
         Rogue_ModifyTrainer(trainerNum, &trainer);
         
         if (firstTrainer == TRUE)
@@ -2096,6 +2099,8 @@ static u8 CreateNPCTrainerParty(struct Pokemon *party, u16 trainerNum, bool8 fir
             Rogue_PostCreateTrainerParty(trainerNum, party, monsCount);
         }
 
+        PROFILE_END(PROFILE_SECTION_TRAINER_PARTY);
+
         gBattleTypeFlags |= trainer.doubleBattle;
     }
 
@@ -11,6 +11,7 @@
 
 #include "constants/rogue.h"
 #include "rogue.h"
+#include "rogue_profiler.h"
 
 const u16 gMinigameDigits_Pal[] = INCBIN_U16("graphics/link/minigame_digits.gbapal");
 const u32 gMinigameDigits_Gfx[] = INCBIN_U32("graphics/link/minigame_digits.4bpp.lz");
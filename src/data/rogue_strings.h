@@ -367,4 +367,28 @@ const u8 gText_RogueDebug_AdvHeader[] = _("ROGUE ADVPATH");
 const u8 gText_RogueDebug_AdvCount[] = _("\nCount: ");
 const u8 gText_RogueDebug_X[] = _("\nX: ");
 const u8 gText_RogueDebug_Y[] = _("\nY: ");
+
+#ifdef ROGUE_FEATURE_PROFILER
+const u8 gText_RogueDebug_ProfileHeader[] = _("ROGUE PROFILE %");
+const u8 gText_RogueDebug_ProfileFrame[] = _("\nFrame: ");
+
+static const u8 sText_RogueDebug_ProfileTasks[] = _("\nTasks: ");
+static const u8 sText_RogueDebug_ProfileAnim[] = _("\nAnim: ");
+static const u8 sText_RogueDebug_ProfileOam[] = _("\nOAM: ");
+static const u8 sText_RogueDebug_ProfileFade[] = _("\nFade: ");
+static const u8 sText_RogueDebug_ProfileScript[] = _("\nScript: ");
+static const u8 sText_RogueDebug_ProfileParty[] = _("\nParty: ");
+static const u8 sText_RogueDebug_ProfileAdvPath[] = _("\nAdvPath: ");
+
+const u8* const gText_RogueDebug_ProfileSections[PROFILE_SECTION_COUNT] =
+{
+    [PROFILE_SECTION_TASKS] = sText_RogueDebug_ProfileTasks,
+    [PROFILE_SECTION_ANIMATE_SPRITES] = sText_RogueDebug_ProfileAnim,
+    [PROFILE_SECTION_BUILD_OAM] = sText_RogueDebug_ProfileOam,
+    [PROFILE_SECTION_PALETTE_FADE] = sText_RogueDebug_ProfileFade,
+    [PROFILE_SECTION_SCRIPT] = sText_RogueDebug_ProfileScript,
+    [PROFILE_SECTION_TRAINER_PARTY] = sText_RogueDebug_ProfileParty,
+    [PROFILE_SECTION_ADVENTURE_PATHS] = sText_RogueDebug_ProfileAdvPath,
+};
+#endif
 #endif
\ No newline at end of file
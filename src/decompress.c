@@ -7,15 +7,174 @@
 
 #include "rogue_controller.h"
 
+// Recently decompressed ROM assets, kept so that reloading the same pic or
+// sheet is a copy instead of another LZ77 pass. Entries are packed from the
+// start of data in the order they were added, so evicting one slides the
+// later ones down.
+// The cache lives on the heap and only exists between OpenDecompressionCache
+// and CloseDecompressionCache, so screens that keep reloading the same few pics
+// (the PC's display mon) pay for it and nothing else does.
+#define DECOMPRESS_CACHE_SIZE    0x1000 // Two 64x64 front pics
+#define DECOMPRESS_CACHE_ENTRIES 4
+
+struct DecompressCacheEntry
+{
+    const u32 *src;
+    u32 lastUsed;
+    u16 offset;
+    u16 size;
+};
+
+struct DecompressCache
+{
+    u32 useCounter;
+    u16 usedBytes;
+    u8 count;
+#ifndef NDEBUG
+    u16 hits;
+    u16 misses;
+#endif
+    struct DecompressCacheEntry entries[DECOMPRESS_CACHE_ENTRIES];
+    u32 data[DECOMPRESS_CACHE_SIZE / 4];
+};
+
 EWRAM_DATA ALIGNED(4) u8 gDecompressionBuffer[0x4000] = {0};
+EWRAM_DATA static struct DecompressCache *sDecompressCache = NULL;
 
 static void DuplicateDeoxysTiles(void *pointer, s32 species);
 
+static bool8 IsCacheableAsset(const u32 *src, u32 size)
+{
+    // Anything outside of ROM could change under us.
+    if ((u32)src < ROM_START)
+        return FALSE;
+
+    return size != 0 && size <= DECOMPRESS_CACHE_SIZE && (size & 3) == 0;
+}
+
+static bool8 CopyFromDecompressCache(const u32 *src, void *dest)
+{
+    u8 i;
+    struct DecompressCacheEntry *entry;
+
+    for (i = 0; i < sDecompressCache->count; i++)
+    {
+        entry = &sDecompressCache->entries[i];
+        if (entry->src == src)
+        {
+            entry->lastUsed = ++sDecompressCache->useCounter;
+            CpuCopy32(&sDecompressCache->data[entry->offset / 4], dest, entry->size);
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static void EvictDecompressCacheEntry(u8 index)
+{
+    u8 i;
+    u16 size = sDecompressCache->entries[index].size;
+    u16 offset = sDecompressCache->entries[index].offset;
+    u16 tailBytes = sDecompressCache->usedBytes - offset - size;
+
+    // Copying forwards is safe as the data only ever moves down.
+    if (tailBytes != 0)
+        CpuCopy32(&sDecompressCache->data[(offset + size) / 4], &sDecompressCache->data[offset / 4], tailBytes);
+
+    for (i = index + 1; i < sDecompressCache->count; i++)
+    {
+        sDecompressCache->entries[i - 1] = sDecompressCache->entries[i];
+        sDecompressCache->entries[i - 1].offset -= size;
+    }
+
+    sDecompressCache->count--;
+    sDecompressCache->usedBytes -= size;
+}
+
+static void EvictLeastRecentlyUsed(void)
+{
+    u8 i;
+    u8 oldest = 0;
+
+    for (i = 1; i < sDecompressCache->count; i++)
+    {
+        if (sDecompressCache->entries[i].lastUsed < sDecompressCache->entries[oldest].lastUsed)
+            oldest = i;
+    }
+
+    EvictDecompressCacheEntry(oldest);
+}
+
+static void AddToDecompressCache(const u32 *src, const void *data, u32 size)
+{
+    struct DecompressCacheEntry *entry;
+
+    if (!IsCacheableAsset(src, size))
+        return;
+
+    while (sDecompressCache->count == DECOMPRESS_CACHE_ENTRIES || sDecompressCache->usedBytes + size > DECOMPRESS_CACHE_SIZE)
+        EvictLeastRecentlyUsed();
+
+    entry = &sDecompressCache->entries[sDecompressCache->count++];
+    entry->src = src;
+    entry->lastUsed = ++sDecompressCache->useCounter;
+    entry->offset = sDecompressCache->usedBytes;
+    entry->size = size;
+
+    CpuCopy32(data, &sDecompressCache->data[entry->offset / 4], size);
+    sDecompressCache->usedBytes += size;
+}
+
+// Returns FALSE if there wasn't room on the heap, in which case loads just
+// decompress as normal.
+bool8 OpenDecompressionCache(void)
+{
+    if (sDecompressCache == NULL)
+        sDecompressCache = AllocZeroed(sizeof(struct DecompressCache));
+
+    return sDecompressCache != NULL;
+}
+
+void CloseDecompressionCache(void)
+{
+#ifndef NDEBUG
+    if (sDecompressCache != NULL)
+        DebugPrintf("Decompression cache: %d hits, %d misses", sDecompressCache->hits, sDecompressCache->misses);
+#endif
+
+    TRY_FREE_AND_SET_NULL(sDecompressCache);
+}
+
 void LZDecompressWram(const u32 *src, void *dest)
 {
     LZ77UnCompWram(src, dest);
 }
 
+// Same as LZDecompressWram, but goes through the decompression cache while
+// one is open.
+void LZDecompressWramCached(const u32 *src, void *dest)
+{
+    if (sDecompressCache == NULL)
+    {
+        LZ77UnCompWram(src, dest);
+    }
+    else if (CopyFromDecompressCache(src, dest))
+    {
+#ifndef NDEBUG
+        sDecompressCache->hits++;
+#endif
+    }
+    else
+    {
+#ifndef NDEBUG
+        sDecompressCache->misses++;
+#endif
+        LZ77UnCompWram(src, dest);
+        AddToDecompressCache(src, dest, GetDecompressedDataSize(src));
+    }
+}
+
 void LZDecompressVram(const u32 *src, void *dest)
 {
     LZ77UnCompVram(src, dest);
@@ -25,7 +184,7 @@ u16 LoadCompressedSpriteSheet(const struct CompressedSpriteSheet *src)
 {
     struct SpriteSheet dest;
 
-    LZ77UnCompWram(Rogue_ModifyPallete32(src->data), gDecompressionBuffer);
+    LZDecompressWramCached(Rogue_ModifyPallete32(src->data), gDecompressionBuffer);
     dest.data = gDecompressionBuffer;
     dest.size = src->size;
     dest.tag = src->tag;
@@ -36,7 +195,7 @@ void LoadCompressedSpriteSheetOverrideBuffer(const struct CompressedSpriteSheet
 {
     struct SpriteSheet dest;
 
-    LZ77UnCompWram(Rogue_ModifyPallete32(src->data), buffer);
+    LZDecompressWramCached(Rogue_ModifyPallete32(src->data), buffer);
     dest.data = buffer;
     dest.size = src->size;
     dest.tag = src->tag;
@@ -47,7 +206,7 @@ void LoadCompressedSpritePalette(const struct CompressedSpritePalette *src)
 {
     struct SpritePalette dest;
 
-    LZ77UnCompWram(Rogue_ModifyPallete32(src->data), gDecompressionBuffer);
+    LZDecompressWramCached(Rogue_ModifyPallete32(src->data), gDecompressionBuffer);
     dest.data = (void*) gDecompressionBuffer;
     dest.tag = src->tag;
     LoadSpritePalette(&dest);
@@ -57,7 +216,7 @@ void LoadCompressedSpritePaletteOverrideBuffer(const struct CompressedSpritePale
 {
     struct SpritePalette dest;
 
-    LZ77UnCompWram(Rogue_ModifyPallete32(src->data), buffer);
+    LZDecompressWramCached(Rogue_ModifyPallete32(src->data), buffer);
     dest.data = buffer;
     dest.tag = src->tag;
     LoadSpritePalette(&dest);
@@ -66,9 +225,9 @@ void LoadCompressedSpritePaletteOverrideBuffer(const struct CompressedSpritePale
 void DecompressPicFromTable(const struct CompressedSpriteSheet *src, void* buffer, s32 species)
 {
     if (species > NUM_SPECIES)
-        LZ77UnCompWram(gMonFrontPicTable[0].data, buffer);
+        LZDecompressWramCached(gMonFrontPicTable[0].data, buffer);
     else
-        LZ77UnCompWram(Rogue_ModifyPallete32(src->data), buffer);
+        LZDecompressWramCached(Rogue_ModifyPallete32(src->data), buffer);
     DuplicateDeoxysTiles(buffer, species);
 }
 
@@ -97,14 +256,14 @@ void LoadSpecialPokePic(const struct CompressedSpriteSheet *src, void *dest, s32
             i += SPECIES_UNOWN_B - 1;
 
         if (!isFrontPic)
-            LZ77UnCompWram(gMonBackPicTable[i].data, dest);
+            LZDecompressWramCached(gMonBackPicTable[i].data, dest);
         else
-            LZ77UnCompWram(gMonFrontPicTable[i].data, dest);
+            LZDecompressWramCached(gMonFrontPicTable[i].data, dest);
     }
     else if (species > NUM_SPECIES) // is species unknown? draw the ? icon
-        LZ77UnCompWram(gMonFrontPicTable[0].data, dest);
+        LZDecompressWramCached(gMonFrontPicTable[0].data, dest);
     else
-        LZ77UnCompWram(Rogue_ModifyPallete32(src->data), dest);
+        LZDecompressWramCached(Rogue_ModifyPallete32(src->data), dest);
 
     DuplicateDeoxysTiles(dest, species);
     DrawSpindaSpots(species, personality, dest, isFrontPic);
@@ -271,7 +430,7 @@ bool8 LoadCompressedSpriteSheetUsingHeap(const struct CompressedSpriteSheet* src
     void* buffer;
 
     buffer = AllocZeroed(*((u32*)(&src->data[0])) >> 8);
-    LZ77UnCompWram(Rogue_ModifyPallete32(src->data), buffer);
+    LZDecompressWramCached(Rogue_ModifyPallete32(src->data), buffer);
 
     dest.data = buffer;
     dest.size = src->size;
@@ -288,7 +447,7 @@ bool8 LoadCompressedSpritePaletteUsingHeap(const struct CompressedSpritePalette
     void* buffer;
 
     buffer = AllocZeroed(*((u32*)(&src->data[0])) >> 8);
-    LZ77UnCompWram(Rogue_ModifyPallete32(src->data), buffer);
+    LZDecompressWramCached(Rogue_ModifyPallete32(src->data), buffer);
     dest.data = buffer;
     dest.tag = src->tag;
 
@@ -300,9 +459,9 @@ bool8 LoadCompressedSpritePaletteUsingHeap(const struct CompressedSpritePalette
 void DecompressPicFromTable_2(const struct CompressedSpriteSheet *src, void* buffer, s32 species) // a copy of DecompressPicFromTable
 {
     if (species > NUM_SPECIES)
-        LZ77UnCompWram(gMonFrontPicTable[0].data, buffer);
+        LZDecompressWramCached(gMonFrontPicTable[0].data, buffer);
     else
-        LZ77UnCompWram(Rogue_ModifyPallete32(src->data), buffer);
+        LZDecompressWramCached(Rogue_ModifyPallete32(src->data), buffer);
     DuplicateDeoxysTiles(buffer, species);
 }
 
@@ -319,14 +478,14 @@ void LoadSpecialPokePic_2(const struct CompressedSpriteSheet *src, void *dest, s
             i += SPECIES_UNOWN_B - 1;
 
         if (!isFrontPic)
-            LZ77UnCompWram(gMonBackPicTable[i].data, dest);
+            LZDecompressWramCached(gMonBackPicTable[i].data, dest);
         else
-            LZ77UnCompWram(gMonFrontPicTable[i].data, dest);
+            LZDecompressWramCached(gMonFrontPicTable[i].data, dest);
     }
     else if (species > NUM_SPECIES) // is species unknown? draw the ? icon
-        LZ77UnCompWram(gMonFrontPicTable[0].data, dest);
+        LZDecompressWramCached(gMonFrontPicTable[0].data, dest);
     else
-        LZ77UnCompWram(Rogue_ModifyPallete32(src->data), dest);
+        LZDecompressWramCached(Rogue_ModifyPallete32(src->data), dest);
 
     DuplicateDeoxysTiles(dest, species);
     DrawSpindaSpots(species, personality, dest, isFrontPic);
@@ -347,9 +506,9 @@ void HandleLoadSpecialPokePic_2(const struct CompressedSpriteSheet *src, void *d
 void DecompressPicFromTable_DontHandleDeoxys(const struct CompressedSpriteSheet *src, void* buffer, s32 species)
 {
     if (species > NUM_SPECIES)
-        LZ77UnCompWram(gMonFrontPicTable[0].data, buffer);
+        LZDecompressWramCached(gMonFrontPicTable[0].data, buffer);
     else
-        LZ77UnCompWram(Rogue_ModifyPallete32(src->data), buffer);
+        LZDecompressWramCached(Rogue_ModifyPallete32(src->data), buffer);
 }
 
 void HandleLoadSpecialPokePic_DontHandleDeoxys(const struct CompressedSpriteSheet *src, void *dest, s32 species, u32 personality)
@@ -377,14 +536,14 @@ void LoadSpecialPokePic_DontHandleDeoxys(const struct CompressedSpriteSheet *src
             i += SPECIES_UNOWN_B - 1;
 
         if (!isFrontPic)
-            LZ77UnCompWram(gMonBackPicTable[i].data, dest);
+            LZDecompressWramCached(gMonBackPicTable[i].data, dest);
         else
-            LZ77UnCompWram(gMonFrontPicTable[i].data, dest);
+            LZDecompressWramCached(gMonFrontPicTable[i].data, dest);
     }
     else if (species > NUM_SPECIES) // is species unknown? draw the ? icon
-        LZ77UnCompWram(gMonFrontPicTable[0].data, dest);
+        LZDecompressWramCached(gMonFrontPicTable[0].data, dest);
     else
-        LZ77UnCompWram(Rogue_ModifyPallete32(src->data), dest);
+        LZDecompressWramCached(Rogue_ModifyPallete32(src->data), dest);
 
     DrawSpindaSpots(species, personality, dest, isFrontPic);
 }
@@ -32,6 +32,13 @@ static bool8 CheckPyramidBagHasSpace(u16 itemId, u16 count);
 // EWRAM variables
 EWRAM_DATA struct BagPocket gBagPockets[POCKETS_COUNT] = {0};
 
+// Total quantity of each item in the bag, so lookups don't have to scan a
+// pocket. Quantities are stored decrypted, so the encryption key can change
+// without touching it. AddBagItem and RemoveBagItem keep it up to date; any
+// other write to the pockets must call InvalidateBagItemIndex.
+EWRAM_DATA static u16 sBagItemCounts[ITEMS_COUNT] = {0};
+EWRAM_DATA static bool8 sBagItemCountsValid = FALSE;
+
 // rodata
 #include "data/text/item_descriptions.h"
 #include "data/items.h"
@@ -88,6 +95,47 @@ void SetBagItemsPointers(void)
 
     gBagPockets[BERRIES_POCKET].itemSlots = gSaveBlock1Ptr->bagPocket_Berries;
     gBagPockets[BERRIES_POCKET].capacity = BAG_BERRIES_COUNT;
+
+    InvalidateBagItemIndex();
+}
+
+void InvalidateBagItemIndex(void)
+{
+    sBagItemCountsValid = FALSE;
+}
+
+static void RebuildBagItemIndex(void)
+{
+    u8 pocket;
+    u16 i;
+    u16 itemId;
+
+    CpuFill16(0, sBagItemCounts, sizeof(sBagItemCounts));
+
+    for (pocket = 0; pocket < POCKETS_COUNT; pocket++)
+    {
+        for (i = 0; i < gBagPockets[pocket].capacity; i++)
+        {
+            itemId = gBagPockets[pocket].itemSlots[i].itemId;
+
+            // Lookups only ever searched the item's own pocket
+            if (itemId != ITEM_NONE && itemId < ITEMS_COUNT && ItemId_GetPocket(itemId) == pocket + 1)
+                sBagItemCounts[itemId] += GetBagItemQuantity(&gBagPockets[pocket].itemSlots[i].quantity);
+        }
+    }
+
+    sBagItemCountsValid = TRUE;
+}
+
+static u16 GetIndexedBagItemCount(u16 itemId)
+{
+    if (itemId >= ITEMS_COUNT)
+        return 0;
+
+    if (!sBagItemCountsValid)
+        RebuildBagItemIndex();
+
+    return sBagItemCounts[itemId];
 }
 
 void CopyItemName(u16 itemId, u8 *dst)
@@ -170,53 +218,23 @@ bool8 IsBagPocketNonEmpty(u8 pocket)
 
 bool8 CheckBagHasItem(u16 itemId, u16 count)
 {
-    u8 i;
-    u8 pocket;
+    u16 quantity;
 
     if (ItemId_GetPocket(itemId) == 0)
         return FALSE;
     if (InBattlePyramid() || FlagGet(FLAG_STORING_ITEMS_IN_PYRAMID_BAG) == TRUE)
         return CheckPyramidBagHasItem(itemId, count);
-    pocket = ItemId_GetPocket(itemId) - 1;
-    // Check for item slots that contain the item
-    for (i = 0; i < gBagPockets[pocket].capacity; i++)
-    {
-        if (gBagPockets[pocket].itemSlots[i].itemId == itemId)
-        {
-            u16 quantity;
-            // Does this item slot contain enough of the item?
-            quantity = GetBagItemQuantity(&gBagPockets[pocket].itemSlots[i].quantity);
-            if (quantity >= count)
-                return TRUE;
-            count -= quantity;
-            // Does this item slot and all previous slots contain enough of the item?
-            if (count == 0)
-                return TRUE;
-        }
-    }
-    return FALSE;
+
+    quantity = GetIndexedBagItemCount(itemId);
+    return quantity != 0 && quantity >= count;
 }
 
 u16 GetItemCountInBag(u16 itemId)
 {
-    u8 i;
-    u8 pocket;
-    u16 count = 0;
-
     if (ItemId_GetPocket(itemId) == 0)
-        return count;
-    
-    pocket = ItemId_GetPocket(itemId) - 1;
+        return 0;
 
-    // Check for item slots that contain the item
-    for (i = 0; i < gBagPockets[pocket].capacity; i++)
-    {
-        if (gBagPockets[pocket].itemSlots[i].itemId == itemId)
-        {            
-            count += GetBagItemQuantity(&gBagPockets[pocket].itemSlots[i].quantity);
-        }
-    }
-    return count;
+    return GetIndexedBagItemCount(itemId);
 }
 
 bool8 HasAtLeastOneBerry(void)
@@ -317,6 +335,7 @@ bool8 AddBagItem(u16 itemId, u16 count)
         struct ItemSlot *newItems;
         u16 slotCapacity;
         u16 ownedCount;
+        u16 addedCount = count;
         u8 pocket = ItemId_GetPocket(itemId) - 1;
 
         itemPocket = &gBagPockets[pocket];
@@ -341,6 +360,9 @@ bool8 AddBagItem(u16 itemId, u16 count)
                     memcpy(itemPocket->itemSlots, newItems, itemPocket->capacity * sizeof(struct ItemSlot));
                     Free(newItems);
 
+                    if (sBagItemCountsValid)
+                        sBagItemCounts[itemId] += addedCount;
+
                     QuestNotify_OnAddBagItem(itemId, count);
                     return TRUE;
                 }
@@ -405,6 +427,9 @@ bool8 AddBagItem(u16 itemId, u16 count)
         memcpy(itemPocket->itemSlots, newItems, itemPocket->capacity * sizeof(struct ItemSlot));
         Free(newItems);
 
+        if (sBagItemCountsValid)
+            sBagItemCounts[itemId] += addedCount;
+
         QuestNotify_OnAddBagItem(itemId, count);
 
         if((itemId >= FIRST_ITEM_CHARM && itemId <= LAST_ITEM_CHARM) || (itemId >= FIRST_ITEM_CURSE && itemId <= LAST_ITEM_CURSE))
@@ -437,15 +462,14 @@ bool8 RemoveBagItem(u16 itemId, u16 count)
         pocket = ItemId_GetPocket(itemId) - 1;
         itemPocket = &gBagPockets[pocket];
 
-        for (i = 0; i < itemPocket->capacity; i++)
-        {
-            if (itemPocket->itemSlots[i].itemId == itemId)
-                totalQuantity += GetBagItemQuantity(&itemPocket->itemSlots[i].quantity);
-        }
+        totalQuantity = GetIndexedBagItemCount(itemId);
 
         if (totalQuantity < count)
             return FALSE;   // We don't have enough of the item
 
+        // Everything below removes exactly count, so the index can be updated up front
+        sBagItemCounts[itemId] -= count;
+
         if (CurMapIsSecretBase() == TRUE)
         {
             VarSet(VAR_SECRET_BASE_LOW_TV_FLAGS, VarGet(VAR_SECRET_BASE_LOW_TV_FLAGS) | SECRET_BASE_USED_BAG);
@@ -758,23 +782,14 @@ void ClearBag(void)
     {
         ClearItemSlots(gBagPockets[i].itemSlots, gBagPockets[i].capacity);
     }
-    
+
+    InvalidateBagItemIndex();
     RecalcCharmCurseValues();
 }
 
 u16 CountTotalItemQuantityInBag(u16 itemId)
 {
-    u16 i;
-    u16 ownedCount = 0;
-    struct BagPocket *bagPocket = &gBagPockets[ItemId_GetPocket(itemId) - 1];
-
-    for (i = 0; i < bagPocket->capacity; i++)
-    {
-        if (bagPocket->itemSlots[i].itemId == itemId)
-            ownedCount += GetBagItemQuantity(&bagPocket->itemSlots[i].quantity);
-    }
-
-    return ownedCount;
+    return GetIndexedBagItemCount(itemId);
 }
 
 static bool8 CheckPyramidBagHasItem(u16 itemId, u16 count)
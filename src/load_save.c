@@ -66,6 +66,7 @@ void ClearSav2(void)
 void ClearSav1(void)
 {
     CpuFill16(0, &gSaveblock1, sizeof(struct SaveBlock1DMA));
+    InvalidateBagItemIndex();
 }
 
 // Offset is the sum of the trainer id bytes
@@ -275,6 +276,7 @@ void SavePlayerBag(void)
     gSaveBlock2Ptr->encryptionKey = gLastEncryptionKey;
     ApplyNewEncryptionKeyToBagItems(encryptionKeyBackup);
     gSaveBlock2Ptr->encryptionKey = encryptionKeyBackup; // updated twice?
+    InvalidateBagItemIndex();
 }
 
 void ApplyNewEncryptionKeyToHword(u16 *hWord, u32 newKey)
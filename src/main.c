@@ -16,6 +16,8 @@
 #include "gba/isagbprint.h"
 #include "load_save.h"
 #include "gpu_regs.h"
+#include "palette.h"
+#include "save.h"
 #include "agb_flash.h"
 #include "sound.h"
 #include "battle.h"
@@ -27,6 +29,7 @@
 #include "constants/rgb.h"
 
 #include "rogue_controller.h"
+#include "rogue_profiler.h"
 
 static void VBlankIntr(void);
 static void HBlankIntr(void);
@@ -100,6 +103,8 @@ void AgbMain()
     InitKeys();
     InitIntrHandlers();
     m4aSoundInit();
+    InitPaletteBlendCode();
+    InitSaveChecksumCode();
     EnableVCountIntrAtLine150();
     InitRFU();
     RtcInit();
@@ -136,6 +141,9 @@ void AgbMain()
 
     for (;;)
     {
+#ifdef ROGUE_FEATURE_PROFILER
+        Rogue_ProfilerBeginFrame();
+#endif
         ReadKeys();
 
         if (gSoftResetDisabled == FALSE
@@ -170,6 +178,9 @@ void AgbMain()
 
         PlayTimeCounter_Update();
         MapMusicMain();
+#ifdef ROGUE_FEATURE_PROFILER
+        Rogue_ProfilerEndFrame();
+#endif
         WaitForVBlank();
     }
 }
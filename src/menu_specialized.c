@@ -39,6 +39,9 @@ extern const struct CompressedSpriteSheet gMonFrontPicTable[];
 EWRAM_DATA static u8 sMailboxWindowIds[MAILBOXWIN_COUNT] = {0};
 EWRAM_DATA static struct ListMenuItem *sMailboxList = NULL;
 
+// The list item each quest menu details window was last drawn for
+EWRAM_DATA static s32 sQuestMenuDrawnItems[2] = {0};
+
 static void MailboxMenu_MoveCursorFunc(s32, bool8, struct ListMenu *);
 static void ConditionGraph_CalcRightHalf(struct ConditionGraph *);
 static void ConditionGraph_CalcLeftHalf(struct ConditionGraph *);
@@ -1001,6 +1004,8 @@ void InitQuestMenuWindows(bool8 useContextWindow)
     PutWindowTilemap(3);
     DrawStdFrameWithCustomTileAndPalette(2, 0, 1, 0xE);
     DrawStdFrameWithCustomTileAndPalette(3, 0, 1, 0xE);
+    sQuestMenuDrawnItems[0] = LIST_NOTHING_CHOSEN;
+    sQuestMenuDrawnItems[1] = LIST_NOTHING_CHOSEN;
     QuestMenuDummy();
     ScheduleBgCopyTilemapToVram(1);
 }
@@ -1016,6 +1021,10 @@ u8 LoadQuestMenuMovesList(const struct ListMenuItem *items, u16 numChoices)
     gMultiuseListMenuTemplate.totalItems = numChoices;
     gMultiuseListMenuTemplate.items = items;
 
+    // Item ids mean something else on the new page
+    sQuestMenuDrawnItems[0] = LIST_NOTHING_CHOSEN;
+    sQuestMenuDrawnItems[1] = LIST_NOTHING_CHOSEN;
+
     if (numChoices < 6)
         gMultiuseListMenuTemplate.maxShowed = numChoices;
     else
@@ -1055,37 +1064,35 @@ static void QuestMenuOverview(u8 windowId)
     str = gText_QuestLogTitleOverview;
     x = GetStringCenterAlignXOffset(FONT_NORMAL, str, 0x80);
     AddTextPrinterParameterized(windowId, FONT_NORMAL, str, x, 1, TEXT_SKIP_DRAW, NULL);
-    
-    CopyWindowToVram(windowId, COPYWIN_GFX);
 
     str = gText_QuestLogOverviewCompleted;
-    AddTextPrinterParameterized(windowId, FONT_NARROW, str, 2, 20, 0, NULL);
+    AddTextPrinterParameterized(windowId, FONT_NARROW, str, 2, 20, TEXT_SKIP_DRAW, NULL);
 
     ConvertUIntToDecimalStringN(gStringVar1, GetCompletedQuestPerc(), STR_CONV_MODE_RIGHT_ALIGN, 6);
     StringExpandPlaceholders(gStringVar2, gText_Var1Percent);
     str = gStringVar2;
-    AddTextPrinterParameterized(windowId, FONT_NARROW, str, 50, 20, 0, NULL);
+    AddTextPrinterParameterized(windowId, FONT_NARROW, str, 50, 20, TEXT_SKIP_DRAW, NULL);
 
     str = gText_QuestLogOverviewUnlocked;
-    AddTextPrinterParameterized(windowId, FONT_NARROW, str, 2, 35, 0, NULL);
+    AddTextPrinterParameterized(windowId, FONT_NARROW, str, 2, 35, TEXT_SKIP_DRAW, NULL);
     
     ConvertUIntToDecimalStringN(gStringVar1, GetUnlockedQuestCount(), STR_CONV_MODE_RIGHT_ALIGN, 6);
     str = gStringVar1;
-    AddTextPrinterParameterized(windowId, FONT_NARROW, str, 50, 35, 0, NULL);
+    AddTextPrinterParameterized(windowId, FONT_NARROW, str, 50, 35, TEXT_SKIP_DRAW, NULL);
 
 #ifdef ROGUE_DEBUG
     str = gText_RogueDebug_Header;
-    AddTextPrinterParameterized(windowId, FONT_NARROW, str, 2, 65, 0, NULL);
+    AddTextPrinterParameterized(windowId, FONT_NARROW, str, 2, 65, TEXT_SKIP_DRAW, NULL);
 
     ConvertUIntToDecimalStringN(gStringVar1, QUEST_CAPACITY - 1, STR_CONV_MODE_RIGHT_ALIGN, 6);
     str = gStringVar1;
-    AddTextPrinterParameterized(windowId, FONT_NARROW, str, 50, 65, 0, NULL);
+    AddTextPrinterParameterized(windowId, FONT_NARROW, str, 50, 65, TEXT_SKIP_DRAW, NULL);
 #endif
 
     if(AnyQuestRewardsPending())
     {
         str = gText_QuestLogOverviewRewardsToCollect;
-        AddTextPrinterParameterized(windowId, FONT_SHORT, str, 2, 80, 0, NULL);
+        AddTextPrinterParameterized(windowId, FONT_SHORT, str, 2, 80, TEXT_SKIP_DRAW, NULL);
     }
 }
 
@@ -1103,30 +1110,27 @@ static void QuestMenuPreviewDescription(u32 chosenQuest)
     AddTextPrinterParameterized(0, FONT_NORMAL, str, x, 1, TEXT_SKIP_DRAW, NULL);
 
     if (chosenQuest == LIST_CANCEL || !GetQuestState(chosenQuest, &questState))
-    {
-        CopyWindowToVram(0, COPYWIN_GFX);
         return;
-    }
 
     quest = &gRogueQuests[chosenQuest];
 
     str = quest->desc;
-    AddTextPrinterParameterized(0, FONT_NARROW, str, 2, 20, 0, NULL);
+    AddTextPrinterParameterized(0, FONT_NARROW, str, 2, 20, TEXT_SKIP_DRAW, NULL);
 
     str = gText_QuestLogTitleStatus;
-    AddTextPrinterParameterized(0, FONT_SHORT, str, 2, 80, 0, NULL);
+    AddTextPrinterParameterized(0, FONT_SHORT, str, 2, 80, TEXT_SKIP_DRAW, NULL);
 
     if(Rogue_IsRunActive() && !IsQuestActive(chosenQuest))
     {
         str = gText_QuestLogMarkerInactive;
         x = GetStringRightAlignXOffset(FONT_SHORT, str, 0x80) - 4;
-        AddTextPrinterParameterized(0, FONT_SHORT, str, x, 65, 0, NULL);
+        AddTextPrinterParameterized(0, FONT_SHORT, str, x, 65, TEXT_SKIP_DRAW, NULL);
     }
 
     if(IsQuestRepeatable(chosenQuest) && chosenQuest != QUEST_IronMono2) // Exception for quests who's description is too long
     {
         str = gText_QuestLogMarkerRepeatable;
-        AddTextPrinterParameterized(0, FONT_SHORT, str, 2, 65, 0, NULL);
+        AddTextPrinterParameterized(0, FONT_SHORT, str, 2, 65, TEXT_SKIP_DRAW, NULL);
     }
 
     if(questState.isCompleted)
@@ -1135,7 +1139,7 @@ static void QuestMenuPreviewDescription(u32 chosenQuest)
         str = gText_QuestLogStatusIncomplete;
 
     x = GetStringRightAlignXOffset(FONT_SHORT, str, 0x80) - 4;
-    AddTextPrinterParameterized(0, FONT_SHORT, str, x, 80, 0, NULL);
+    AddTextPrinterParameterized(0, FONT_SHORT, str, x, 80, TEXT_SKIP_DRAW, NULL);
 }
 
 static void QuestMenuRewardDescription(u32 chosenQuest)
@@ -1153,10 +1157,7 @@ static void QuestMenuRewardDescription(u32 chosenQuest)
     AddTextPrinterParameterized(1, FONT_NORMAL, str, x, 1, TEXT_SKIP_DRAW, NULL);
 
     if (chosenQuest == LIST_CANCEL || !GetQuestState(chosenQuest, &questState))
-    {
-        CopyWindowToVram(0, COPYWIN_GFX);
         return;
-    }
 
     quest = &gRogueQuests[chosenQuest];
 
@@ -1203,14 +1204,14 @@ static void QuestMenuRewardDescription(u32 chosenQuest)
             }
         }
 
-        AddTextPrinterParameterized(1, FONT_SHORT, str, 2, 20 + 15 * i, 0, NULL);
+        AddTextPrinterParameterized(1, FONT_SHORT, str, 2, 20 + 15 * i, TEXT_SKIP_DRAW, NULL);
     }
 
     // Add extra text to indicate new quests are unlockable
     if(DoesQuestHaveUnlocks(chosenQuest))
     {
         str = gText_QuestLogTitleQuestUnlocks;
-        AddTextPrinterParameterized(1, FONT_SHORT, str, 2, 20 + 15 * i, 0, NULL);
+        AddTextPrinterParameterized(1, FONT_SHORT, str, 2, 20 + 15 * i, TEXT_SKIP_DRAW, NULL);
     }
 
     if(questState.isCompleted)
@@ -1219,39 +1220,52 @@ static void QuestMenuRewardDescription(u32 chosenQuest)
         {
             str = gText_QuestLogStatusCollection;
             x = GetStringRightAlignXOffset(FONT_SHORT, str, 0x80) - 4;
-            AddTextPrinterParameterized(1, FONT_SHORT, str, x, 80, 0, NULL);
+            AddTextPrinterParameterized(1, FONT_SHORT, str, x, 80, TEXT_SKIP_DRAW, NULL);
         }
         else if(IsQuestRepeatable(chosenQuest))
         {
             str = gText_QuestLogMarkerRepeatable;
             x = GetStringRightAlignXOffset(FONT_SHORT, str, 0x80) - 4;
-            AddTextPrinterParameterized(1, FONT_SHORT, str, x, 80, 0, NULL);
+            AddTextPrinterParameterized(1, FONT_SHORT, str, x, 80, TEXT_SKIP_DRAW, NULL);
         }
         else
         {
             str = gText_QuestLogStatusCollected;
             x = GetStringRightAlignXOffset(FONT_SHORT, str, 0x80) - 4;
-            AddTextPrinterParameterized(1, FONT_SHORT, str, x, 80, 0, NULL);
+            AddTextPrinterParameterized(1, FONT_SHORT, str, x, 80, TEXT_SKIP_DRAW, NULL);
         }
     }
 
 }
 
-static void QuestMenuCursorCallback(s32 itemIndex, bool8 onInit, struct ListMenu *list)
+// Only the details window on screen is drawn. The other one is drawn when the
+// player switches to it, unless it still shows the selected quest.
+void QuestMenuRefreshDetails(s32 itemIndex)
 {
-    if (onInit != TRUE)
-        PlaySE(SE_SELECT);
+    u8 windowId = Rogue_IsQuestMenuRewardsActive() ? 1 : 0;
+
+    if (sQuestMenuDrawnItems[windowId] == itemIndex)
+        return;
+
+    sQuestMenuDrawnItems[windowId] = itemIndex;
 
     if(Rogue_IsQuestMenuOverviewActive())
-    {
-        QuestMenuOverview(0);
-        QuestMenuOverview(1);
-    }
-    else
-    {
+        QuestMenuOverview(windowId);
+    else if(windowId == 0)
         QuestMenuPreviewDescription(itemIndex);
+    else
         QuestMenuRewardDescription(itemIndex);
-    }
+
+    // All the text above skips drawing, so the window goes to VRAM once
+    CopyWindowToVram(windowId, COPYWIN_GFX);
+}
+
+static void QuestMenuCursorCallback(s32 itemIndex, bool8 onInit, struct ListMenu *list)
+{
+    if (onInit != TRUE)
+        PlaySE(SE_SELECT);
+
+    QuestMenuRefreshDetails(itemIndex);
 }
 
 void QuestMenuPrintText(u8 *str)
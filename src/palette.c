@@ -6,6 +6,8 @@
 #include "task.h"
 #include "constants/rgb.h"
 
+#include "rogue_profiler.h"
+
 enum
 {
     NORMAL_FADE,
@@ -56,6 +58,15 @@ static void UpdateBlendRegisters(void);
 static bool8 IsSoftwarePaletteFadeFinishing(void);
 static void Task_BlendPalettesGradually(u8 taskId);
 
+#define BSS_CODE __attribute__((section(".bss.code")))
+
+extern char BlendPaletteWords[];
+extern char BlendPaletteWords_End[];
+
+// ARM blend loop from palette_blend.s, copied here by InitPaletteBlendCode
+// since it runs much faster from IWRAM than from ROM.
+BSS_CODE ALIGNED(4) static char sBlendPaletteWordsBuffer[0x80] = {0};
+
 // palette buffers require alignment with agbcc because
 // unaligned word reads are issued in BlendPalette otherwise
 ALIGNED(4) EWRAM_DATA u16 gPlttBufferUnfaded[PLTT_BUFFER_SIZE] = {0};
@@ -100,6 +111,19 @@ void FillPalette(u16 value, u16 offset, u16 size)
     CpuFill16(value, &gPlttBufferFaded[offset], size);
 }
 
+void InitPaletteBlendCode(void)
+{
+    AGB_ASSERT(BlendPaletteWords_End - BlendPaletteWords <= sizeof(sBlendPaletteWordsBuffer));
+    CpuCopy32(BlendPaletteWords, sBlendPaletteWordsBuffer, sizeof(sBlendPaletteWordsBuffer));
+}
+
+// Blends numWords pairs of colors. Both buffers must be word aligned and coeff
+// at most 16.
+void BlendPaletteWordsRam(const u32 *src, u32 *dest, u32 numWords, u8 coeff, u16 blendColor)
+{
+    ((void (*)(const u32 *, u32 *, u32, u32))sBlendPaletteWordsBuffer)(src, dest, numWords, coeff | (blendColor << 16));
+}
+
 void TransferPlttBuffer(void)
 {
     if (!gPaletteFade.bufferTransferDisabled)
@@ -121,6 +145,8 @@ u8 UpdatePaletteFade(void)
     if (sPlttBufferTransferPending)
         return PALETTE_FADE_STATUS_LOADING;
 
+    PROFILE_BEGIN(PROFILE_SECTION_PALETTE_FADE);
+
     if (gPaletteFade.mode == NORMAL_FADE)
         result = UpdateNormalPaletteFade();
     else if (gPaletteFade.mode == FAST_FADE)
@@ -130,6 +156,8 @@ u8 UpdatePaletteFade(void)
 
     sPlttBufferTransferPending = gPaletteFade.multipurpose1 | dummy;
 
+    PROFILE_END(PROFILE_SECTION_PALETTE_FADE);
+
     return result;
 }
 
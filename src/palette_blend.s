@@ -0,0 +1,53 @@
+	.include "asm/macros.inc"
+
+	.syntax unified
+
+	.text
+
+@ void BlendPaletteWords(const u32 *src, u32 *dest, u32 numWords, u32 coeffAndColor)
+@
+@ Blends pairs of RGB555 colors towards a single color, one 32-bit word per
+@ iteration. coeffAndColor holds the coefficient (0-16) in the low byte and the
+@ blend color in the high halfword. Each channel c becomes
+@   (c * (16 - coeff) + blend * coeff) >> 4
+@ which is what BlendPalette computes. The channels of both colors are spread
+@ over two words with 4 spare bits above each, so one multiply blends three
+@ channels at once.
+@
+@ This runs from IWRAM. InitPaletteBlendCode copies it to
+@ sBlendPaletteWordsBuffer, which is sized to hold everything up to
+@ BlendPaletteWords_End.
+	arm_func_start BlendPaletteWords
+BlendPaletteWords:
+	push {r4-r10}
+	and r4, r3, 0xFF                @ r4 = coeff
+	rsb r5, r4, 16                  @ r5 = 16 - coeff
+	lsr r6, r3, 16
+	orr r6, r6, r6, lsl 16          @ r6 = blend color in both halves
+	ldr r7, =0x03E07C1F             @ r7 = red/blue of the low color, green of the high color
+	ldr r8, =0x03E0F81F             @ r8 = the other three channels, shifted down by 5
+	and r9, r6, r7
+	mul r9, r4, r9                  @ r9 = blend color channels * coeff (first half)
+	and r10, r8, r6, lsr 5
+	mul r10, r4, r10                @ r10 = blend color channels * coeff (second half)
+	cmp r2, 0
+	beq BlendPaletteWords_Done
+BlendPaletteWords_Loop:
+	ldr r3, [r0], 4
+	and r12, r3, r7
+	mla r12, r5, r12, r9
+	and r12, r7, r12, lsr 4
+	and r3, r8, r3, lsr 5
+	mla r3, r5, r3, r10
+	and r3, r8, r3, lsr 4
+	orr r3, r12, r3, lsl 5
+	str r3, [r1], 4
+	subs r2, r2, 1
+	bne BlendPaletteWords_Loop
+BlendPaletteWords_Done:
+	pop {r4-r10}
+	bx lr
+	.pool
+	.global BlendPaletteWords_End
+BlendPaletteWords_End:
+	arm_func_end BlendPaletteWords
@@ -2169,6 +2169,7 @@ void ZeroBoxMonData(struct BoxPokemon *boxMon)
     u32 i;
     for (i = 0; i < sizeof(struct BoxPokemon); i++)
         raw[i] = 0;
+    InvalidateStorageIndexEntry(boxMon);
 }
 
 void ZeroMonData(struct Pokemon *mon)
@@ -3629,86 +3630,18 @@ static void DecryptBoxMon(struct BoxPokemon *boxMon)
     }
 }
 
-#define SUBSTRUCT_CASE(n, v1, v2, v3, v4)                               \
-case n:                                                                 \
-    {                                                                   \
-    union PokemonSubstruct *substructs0 = boxMon->secure.substructs;    \
-    union PokemonSubstruct *substructs1 = boxMon->secure.substructs;    \
-    union PokemonSubstruct *substructs2 = boxMon->secure.substructs;    \
-    union PokemonSubstruct *substructs3 = boxMon->secure.substructs;    \
-    union PokemonSubstruct *substructs4 = boxMon->secure.substructs;    \
-    union PokemonSubstruct *substructs5 = boxMon->secure.substructs;    \
-    union PokemonSubstruct *substructs6 = boxMon->secure.substructs;    \
-    union PokemonSubstruct *substructs7 = boxMon->secure.substructs;    \
-    union PokemonSubstruct *substructs8 = boxMon->secure.substructs;    \
-    union PokemonSubstruct *substructs9 = boxMon->secure.substructs;    \
-    union PokemonSubstruct *substructs10 = boxMon->secure.substructs;   \
-    union PokemonSubstruct *substructs11 = boxMon->secure.substructs;   \
-    union PokemonSubstruct *substructs12 = boxMon->secure.substructs;   \
-    union PokemonSubstruct *substructs13 = boxMon->secure.substructs;   \
-    union PokemonSubstruct *substructs14 = boxMon->secure.substructs;   \
-    union PokemonSubstruct *substructs15 = boxMon->secure.substructs;   \
-    union PokemonSubstruct *substructs16 = boxMon->secure.substructs;   \
-    union PokemonSubstruct *substructs17 = boxMon->secure.substructs;   \
-    union PokemonSubstruct *substructs18 = boxMon->secure.substructs;   \
-    union PokemonSubstruct *substructs19 = boxMon->secure.substructs;   \
-    union PokemonSubstruct *substructs20 = boxMon->secure.substructs;   \
-    union PokemonSubstruct *substructs21 = boxMon->secure.substructs;   \
-    union PokemonSubstruct *substructs22 = boxMon->secure.substructs;   \
-    union PokemonSubstruct *substructs23 = boxMon->secure.substructs;   \
-                                                                        \
-        switch (substructType)                                          \
-        {                                                               \
-        case 0:                                                         \
-            substruct = &substructs ## n [v1];                          \
-            break;                                                      \
-        case 1:                                                         \
-            substruct = &substructs ## n [v2];                          \
-            break;                                                      \
-        case 2:                                                         \
-            substruct = &substructs ## n [v3];                          \
-            break;                                                      \
-        case 3:                                                         \
-            substruct = &substructs ## n [v4];                          \
-            break;                                                      \
-        }                                                               \
-        break;                                                          \
-    }                                                                   \
-
+// Where each of the four substructs is stored, indexed by personality % 24
+static const u8 sSubstructOrders[24][4] =
+{
+    {0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 1, 3}, {0, 3, 1, 2}, {0, 2, 3, 1}, {0, 3, 2, 1},
+    {1, 0, 2, 3}, {1, 0, 3, 2}, {2, 0, 1, 3}, {3, 0, 1, 2}, {2, 0, 3, 1}, {3, 0, 2, 1},
+    {1, 2, 0, 3}, {1, 3, 0, 2}, {2, 1, 0, 3}, {3, 1, 0, 2}, {2, 3, 0, 1}, {3, 2, 0, 1},
+    {1, 2, 3, 0}, {1, 3, 2, 0}, {2, 1, 3, 0}, {3, 1, 2, 0}, {2, 3, 1, 0}, {3, 2, 1, 0},
+};
 
 static union PokemonSubstruct *GetSubstruct(struct BoxPokemon *boxMon, u32 personality, u8 substructType)
 {
-    union PokemonSubstruct *substruct = NULL;
-
-    switch (personality % 24)
-    {
-        SUBSTRUCT_CASE( 0,0,1,2,3)
-        SUBSTRUCT_CASE( 1,0,1,3,2)
-        SUBSTRUCT_CASE( 2,0,2,1,3)
-        SUBSTRUCT_CASE( 3,0,3,1,2)
-        SUBSTRUCT_CASE( 4,0,2,3,1)
-        SUBSTRUCT_CASE( 5,0,3,2,1)
-        SUBSTRUCT_CASE( 6,1,0,2,3)
-        SUBSTRUCT_CASE( 7,1,0,3,2)
-        SUBSTRUCT_CASE( 8,2,0,1,3)
-        SUBSTRUCT_CASE( 9,3,0,1,2)
-        SUBSTRUCT_CASE(10,2,0,3,1)
-        SUBSTRUCT_CASE(11,3,0,2,1)
-        SUBSTRUCT_CASE(12,1,2,0,3)
-        SUBSTRUCT_CASE(13,1,3,0,2)
-        SUBSTRUCT_CASE(14,2,1,0,3)
-        SUBSTRUCT_CASE(15,3,1,0,2)
-        SUBSTRUCT_CASE(16,2,3,0,1)
-        SUBSTRUCT_CASE(17,3,2,0,1)
-        SUBSTRUCT_CASE(18,1,2,3,0)
-        SUBSTRUCT_CASE(19,1,3,2,0)
-        SUBSTRUCT_CASE(20,2,1,3,0)
-        SUBSTRUCT_CASE(21,3,1,2,0)
-        SUBSTRUCT_CASE(22,2,3,1,0)
-        SUBSTRUCT_CASE(23,3,2,1,0)
-    }
-
-    return substruct;
+    return &boxMon->secure.substructs[sSubstructOrders[personality % 24][substructType]];
 }
 
 static void ChangePersonality(struct BoxPokemon *boxMon, u32 personality)
@@ -3811,7 +3744,25 @@ u32 GetMonData(struct Pokemon *mon, s32 field, u8* data)
     return ret;
 }
 
-u32 GetBoxMonData(struct BoxPokemon *boxMon, s32 field, u8 *data)
+// Decrypts boxMon and checks it against its checksum. A mon that fails the
+// check is turned into a Bad Egg, which is what the callers below expect.
+static bool8 DecryptAndValidateBoxMon(struct BoxPokemon *boxMon)
+{
+    DecryptBoxMon(boxMon);
+
+    if (CalculateBoxMonChecksum(boxMon) != boxMon->checksum)
+    {
+        boxMon->isBadEgg = TRUE;
+        boxMon->isEgg = TRUE;
+        GetSubstruct(boxMon, boxMon->personality, 3)->type3.isEgg = TRUE;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+// Reads a field from a box mon that has already been decrypted.
+static u32 GetDecryptedBoxMonData(struct BoxPokemon *boxMon, s32 field, u8 *data)
 {
     s32 i;
     u32 retVal = 0;
@@ -3820,22 +3771,12 @@ u32 GetBoxMonData(struct BoxPokemon *boxMon, s32 field, u8 *data)
     struct PokemonSubstruct2 *substruct2 = NULL;
     struct PokemonSubstruct3 *substruct3 = NULL;
 
-    // Any field greater than MON_DATA_ENCRYPT_SEPARATOR is encrypted and must be treated as such
     if (field > MON_DATA_ENCRYPT_SEPARATOR)
     {
         substruct0 = &(GetSubstruct(boxMon, boxMon->personality, 0)->type0);
         substruct1 = &(GetSubstruct(boxMon, boxMon->personality, 1)->type1);
         substruct2 = &(GetSubstruct(boxMon, boxMon->personality, 2)->type2);
         substruct3 = &(GetSubstruct(boxMon, boxMon->personality, 3)->type3);
-
-        DecryptBoxMon(boxMon);
-
-        if (CalculateBoxMonChecksum(boxMon) != boxMon->checksum)
-        {
-            boxMon->isBadEgg = TRUE;
-            boxMon->isEgg = TRUE;
-            substruct3->isEgg = TRUE;
-        }
     }
 
     switch (field)
@@ -4161,8 +4102,24 @@ u32 GetBoxMonData(struct BoxPokemon *boxMon, s32 field, u8 *data)
         break;
     }
 
+    return retVal;
+}
+
+u32 GetBoxMonData(struct BoxPokemon *boxMon, s32 field, u8 *data)
+{
+    u32 retVal;
+
+    // Any field greater than MON_DATA_ENCRYPT_SEPARATOR is encrypted and must be treated as such
     if (field > MON_DATA_ENCRYPT_SEPARATOR)
+    {
+        DecryptAndValidateBoxMon(boxMon);
+        retVal = GetDecryptedBoxMonData(boxMon, field, data);
         EncryptBoxMon(boxMon);
+    }
+    else
+    {
+        retVal = GetDecryptedBoxMonData(boxMon, field, data);
+    }
 
     return retVal;
 }
@@ -4215,7 +4172,9 @@ void SetMonData(struct Pokemon *mon, s32 field, const void *dataArg)
     }
 }
 
-void SetBoxMonData(struct BoxPokemon *boxMon, s32 field, const void *dataArg)
+// Writes a field to a box mon that has already been decrypted. The checksum
+// is left for the caller to update.
+static void SetDecryptedBoxMonData(struct BoxPokemon *boxMon, s32 field, const void *dataArg)
 {
     const u8 *data = dataArg;
 
@@ -4230,17 +4189,6 @@ void SetBoxMonData(struct BoxPokemon *boxMon, s32 field, const void *dataArg)
         substruct1 = &(GetSubstruct(boxMon, boxMon->personality, 1)->type1);
         substruct2 = &(GetSubstruct(boxMon, boxMon->personality, 2)->type2);
         substruct3 = &(GetSubstruct(boxMon, boxMon->personality, 3)->type3);
-
-        DecryptBoxMon(boxMon);
-
-        if (CalculateBoxMonChecksum(boxMon) != boxMon->checksum)
-        {
-            boxMon->isBadEgg = TRUE;
-            boxMon->isEgg = TRUE;
-            substruct3->isEgg = TRUE;
-            EncryptBoxMon(boxMon);
-            return;
-        }
     }
 
     switch (field)
@@ -4478,12 +4426,75 @@ void SetBoxMonData(struct BoxPokemon *boxMon, s32 field, const void *dataArg)
     default:
         break;
     }
+}
+
+void SetBoxMonData(struct BoxPokemon *boxMon, s32 field, const void *dataArg)
+{
+    InvalidateStorageIndexEntry(boxMon);
 
     if (field > MON_DATA_ENCRYPT_SEPARATOR)
     {
-        boxMon->checksum = CalculateBoxMonChecksum(boxMon);
+        if (DecryptAndValidateBoxMon(boxMon))
+        {
+            SetDecryptedBoxMonData(boxMon, field, dataArg);
+            boxMon->checksum = CalculateBoxMonChecksum(boxMon);
+        }
         EncryptBoxMon(boxMon);
     }
+    else
+    {
+        SetDecryptedBoxMonData(boxMon, field, dataArg);
+    }
+}
+
+// A box mon view is a decrypted copy of a box mon, checked once when it is
+// opened. Any number of fields can then be read and written without paying
+// for the decryption and checksum each time, and CommitBoxMonView writes the
+// changes back with a single checksum and encryption. Changing the
+// personality or OT id through a view isn't supported, as they are the
+// encryption key (use SetMonPersonality instead).
+void OpenBoxMonView(struct BoxMonView *view, struct BoxPokemon *boxMon)
+{
+    view->source = boxMon;
+    view->mon = *boxMon;
+    view->isDirty = FALSE;
+    view->isValid = DecryptAndValidateBoxMon(&view->mon);
+
+    // Reading a corrupt mon marks it as a Bad Egg, same as GetBoxMonData
+    if (!view->isValid)
+    {
+        *boxMon = view->mon;
+        EncryptBoxMon(boxMon);
+    }
+}
+
+u32 GetBoxMonViewData(struct BoxMonView *view, s32 field, u8 *data)
+{
+    return GetDecryptedBoxMonData(&view->mon, field, data);
+}
+
+void SetBoxMonViewData(struct BoxMonView *view, s32 field, const void *data)
+{
+    // SetBoxMonData refuses to write to a Bad Egg
+    if (view->isValid || field <= MON_DATA_ENCRYPT_SEPARATOR)
+    {
+        SetDecryptedBoxMonData(&view->mon, field, data);
+        view->isDirty = TRUE;
+    }
+}
+
+void CommitBoxMonView(struct BoxMonView *view)
+{
+    if (view->isDirty)
+    {
+        if (view->isValid)
+            view->mon.checksum = CalculateBoxMonChecksum(&view->mon);
+
+        *view->source = view->mon;
+        EncryptBoxMon(view->source);
+        InvalidateStorageIndexEntry(view->source);
+        view->isDirty = FALSE;
+    }
 }
 
 void CopyMon(void *dest, void *src, size_t size)
@@ -4534,7 +4545,7 @@ static u8 SendMonToPC(struct Pokemon* mon)
         for (boxPos = 0; boxPos < IN_BOX_COUNT; boxPos++)
         {
             struct BoxPokemon* checkingMon = GetBoxedMonPtr(boxNo, boxPos);
-            if (GetBoxMonData(checkingMon, MON_DATA_SPECIES, NULL) == SPECIES_NONE)
+            if (GetIndexedBoxMonSpecies(boxNo, boxPos) == SPECIES_NONE)
             {
                 MonRestorePP(mon);
                 CopyMon(checkingMon, &mon->box, sizeof(mon->box));
@@ -569,6 +569,7 @@ EWRAM_DATA static u8 sWhichToReshow = 0;
 EWRAM_DATA static u8 sLastUsedBox = 0;
 EWRAM_DATA static u16 sMovingItemId = 0;
 EWRAM_DATA static struct Pokemon sSavedMovingMon = {0};
+EWRAM_DATA static struct StorageIndexEntry sStorageIndex[TOTAL_BOXES_COUNT][IN_BOX_COUNT] = {0};
 EWRAM_DATA static s8 sCursorArea = 0;
 EWRAM_DATA static s8 sCursorPosition = 0;
 EWRAM_DATA static bool8 sIsMonBeingMoved = 0;
@@ -2014,6 +2015,7 @@ static void EnterPokeStorage(u8 boxOption)
         sStorage->state = 0;
         sStorage->taskId = CreateTask(Task_InitPokeStorage, 3);
         sLastUsedBox = StorageGetCurrentBox();
+        OpenDecompressionCache();
         SetMainCallback2(CB2_PokeStorage);
     }
 }
@@ -2032,6 +2034,7 @@ static void CB2_ReturnToPokeStorage(void)
         sStorage->isReopening = TRUE;
         sStorage->state = 0;
         sStorage->taskId = CreateTask(Task_InitPokeStorage, 3);
+        OpenDecompressionCache();
         SetMainCallback2(CB2_PokeStorage);
     }
 }
@@ -3792,6 +3795,7 @@ static void FreePokeStorageData(void)
 {
     TilemapUtil_Free();
     MultiMove_Free();
+    CloseDecompressionCache();
     FREE_AND_SET_NULL(sStorage);
     FreeAllWindowBuffers();
 }
@@ -9479,7 +9483,10 @@ u32 GetAndCopyBoxMonDataAt(u8 boxId, u8 boxPosition, s32 request, void *dst)
 void SetBoxMonAt(u8 boxId, u8 boxPosition, struct BoxPokemon *src)
 {
     if (boxId < TOTAL_BOXES_COUNT && boxPosition < IN_BOX_COUNT)
+    {
         gPokemonStoragePtr->boxes[boxId][boxPosition] = *src;
+        sStorageIndex[boxId][boxPosition].flags = 0;
+    }
 }
 
 void CopyBoxMonAt(u8 boxId, u8 boxPosition, struct BoxPokemon *dst)
@@ -9659,14 +9666,15 @@ bool32 AnyStorageMonWithMove(u16 moveId)
 bool8 AnyStorageMonOfSpecies(u16 species)
 {
     s32 i, j;
+    const struct StorageIndexEntry *entry;
 
     for (i = 0; i < TOTAL_BOXES_COUNT; i++)
     {
         for (j = 0; j < IN_BOX_COUNT; j++)
         {
-            if (GetBoxMonData(&gPokemonStoragePtr->boxes[i][j], MON_DATA_SANITY_HAS_SPECIES)
-                && !GetBoxMonData(&gPokemonStoragePtr->boxes[i][j], MON_DATA_SANITY_IS_EGG)
-                && GetBoxMonData(&gPokemonStoragePtr->boxes[i][j], MON_DATA_SPECIES) == species)
+            entry = GetStorageIndexEntry(i, j);
+            if ((entry->flags & (STORAGE_INDEX_HAS_SPECIES | STORAGE_INDEX_IS_EGG)) == STORAGE_INDEX_HAS_SPECIES
+                && entry->species == species)
                 return TRUE;
         }
     }
@@ -9690,6 +9698,118 @@ bool8 AnyPlayerPartyMonOfSpecies(u16 species)
 }
 
 
+//------------------------------------------------------------------------------
+//  SECTION: Storage index
+//
+//  The species and held item of every box mon, so that searching the PC
+//  doesn't have to decrypt every mon in it. The write paths that go through
+//  pokemon.c and the box accessors here (SetBoxMonData, CommitBoxMonView,
+//  ZeroBoxMonData, SetBoxMonAt) invalidate the entry they touch, and loading
+//  a save invalidates the whole index.
+//  Code that copies mons into the boxes some other way (e.g. through
+//  GetBoxedMonPtr) is only caught by a heuristic: each entry remembers the
+//  unencrypted header it was built from, and is re-decoded once that no longer
+//  matches. The checksum is a 16-bit sum, so an edit that leaves it unchanged
+//  can be missed there.
+//------------------------------------------------------------------------------
+
+
+void InvalidateStorageIndex(void)
+{
+    memset(sStorageIndex, 0, sizeof(sStorageIndex));
+}
+
+// A flags of 0 never matches, as GetBoxMonIndexFlags always sets STORAGE_INDEX_VALID.
+// Pointers outside of the boxes are ignored, so this is safe to call for any mon.
+void InvalidateStorageIndexEntry(const struct BoxPokemon *boxMon)
+{
+    const struct BoxPokemon *boxes = &gPokemonStoragePtr->boxes[0][0];
+
+    if (boxMon >= boxes && boxMon < boxes + TOTAL_BOXES_COUNT * IN_BOX_COUNT)
+        (&sStorageIndex[0][0])[boxMon - boxes].flags = 0;
+}
+
+static u8 GetBoxMonIndexFlags(const struct BoxPokemon *boxMon)
+{
+    u8 flags = STORAGE_INDEX_VALID;
+
+    if (boxMon->hasSpecies)
+        flags |= STORAGE_INDEX_HAS_SPECIES;
+    if (boxMon->isEgg)
+        flags |= STORAGE_INDEX_IS_EGG;
+    if (boxMon->isBadEgg)
+        flags |= STORAGE_INDEX_IS_BAD_EGG;
+
+    return flags;
+}
+
+static void UpdateStorageIndexEntry(struct StorageIndexEntry *entry, struct BoxMonView *view)
+{
+    entry->species = GetBoxMonViewData(view, MON_DATA_SPECIES, NULL);
+    entry->heldItem = GetBoxMonViewData(view, MON_DATA_HELD_ITEM, NULL);
+
+    // Taken from the stored mon, as opening the view can turn it into a Bad Egg
+    entry->personality = view->source->personality;
+    entry->checksum = view->source->checksum;
+    entry->flags = GetBoxMonIndexFlags(view->source);
+}
+
+const struct StorageIndexEntry *GetStorageIndexEntry(u8 boxId, u8 boxPosition)
+{
+    struct StorageIndexEntry *entry = &sStorageIndex[boxId][boxPosition];
+    struct BoxPokemon *boxMon = &gPokemonStoragePtr->boxes[boxId][boxPosition];
+    struct BoxMonView view;
+
+    if (entry->personality != boxMon->personality
+     || entry->checksum != boxMon->checksum
+     || entry->flags != GetBoxMonIndexFlags(boxMon))
+    {
+        OpenBoxMonView(&view, boxMon);
+        UpdateStorageIndexEntry(entry, &view);
+    }
+
+    return entry;
+}
+
+u16 GetIndexedBoxMonSpecies(u8 boxId, u8 boxPosition)
+{
+    if (boxId < TOTAL_BOXES_COUNT && boxPosition < IN_BOX_COUNT)
+        return GetStorageIndexEntry(boxId, boxPosition)->species;
+    else
+        return SPECIES_NONE;
+}
+
+u16 GetIndexedBoxMonHeldItem(u8 boxId, u8 boxPosition)
+{
+    if (boxId < TOTAL_BOXES_COUNT && boxPosition < IN_BOX_COUNT)
+        return GetStorageIndexEntry(boxId, boxPosition)->heldItem;
+    else
+        return ITEM_NONE;
+}
+
+// Calls func once for every occupied box slot with a decrypted view of the mon,
+// which is committed (if func changed it) and reindexed afterwards.
+void ForEachStorageMon(void (*func)(struct BoxMonView *view, u8 boxId, u8 boxPosition))
+{
+    u8 boxId, boxPosition;
+    struct BoxMonView view;
+
+    for (boxId = 0; boxId < TOTAL_BOXES_COUNT; boxId++)
+    {
+        for (boxPosition = 0; boxPosition < IN_BOX_COUNT; boxPosition++)
+        {
+            if (GetStorageIndexEntry(boxId, boxPosition)->species == SPECIES_NONE)
+                continue;
+
+            OpenBoxMonView(&view, &gPokemonStoragePtr->boxes[boxId][boxPosition]);
+            func(&view, boxId, boxPosition);
+            CommitBoxMonView(&view);
+            UpdateStorageIndexEntry(&sStorageIndex[boxId][boxPosition], &view);
+        }
+    }
+}
+
+
 //------------------------------------------------------------------------------
 //  SECTION: Walda
 //------------------------------------------------------------------------------
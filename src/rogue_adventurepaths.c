@@ -16,6 +16,7 @@
 
 #include "rogue_adventurepaths.h"
 #include "rogue_campaign.h"
+#include "rogue_profiler.h"
 
 // Bridge refers to horizontal paths
 // Ladder refers to vertical
@@ -69,8 +70,8 @@ struct AdvMapScratch
 
 EWRAM_DATA struct AdvMapScratch* gAdvPathScratch = NULL;
 
-static void AllocAdvPathScratch(void);
-static void FreeAdvPathScratch(void);
+static void BeginAdvPathScratch(struct AdvMapScratch* scratch);
+static void EndAdvPathScratch(void);
 static void FlipAdvPathNodes(void);
 static struct AdvEventScratch* GetScratchReadNode(u16 i);
 static struct AdvEventScratch* GetScratchWriteNode(u16 i);
@@ -871,6 +872,7 @@ static void SetRogueSeedForNode()
 
 bool8 RogueAdv_GenerateAdventurePathsIfRequired()
 {
+    struct AdvMapScratch scratch;
     struct RogueAdvPathNode* nodeInfo;
     u8 i;
     u8 totalDistance;
@@ -882,7 +884,9 @@ bool8 RogueAdv_GenerateAdventurePathsIfRequired()
         return FALSE;
     }
 
-    AllocAdvPathScratch();
+    PROFILE_BEGIN(PROFILE_SECTION_ADVENTURE_PATHS);
+
+    BeginAdvPathScratch(&scratch);
 
     SetRogueSeedForPath();
 
@@ -916,7 +920,7 @@ bool8 RogueAdv_GenerateAdventurePathsIfRequired()
         GenerateAdventureColumnEvents(totalDistance - i - 1, totalDistance);
     }
 
-    FreeAdvPathScratch();
+    EndAdvPathScratch();
 
     minY = MAX_PATH_ROWS;
     maxY = 0;
@@ -942,6 +946,8 @@ bool8 RogueAdv_GenerateAdventurePathsIfRequired()
     gRogueAdvPath.currentColumnCount = totalDistance;
     gRogueAdvPath.currentNodeX = 0;
     gRogueAdvPath.currentNodeY = (minY + maxY) / 2;
+
+    PROFILE_END(PROFILE_SECTION_ADVENTURE_PATHS);
     return TRUE;
 }
 
@@ -1493,16 +1499,18 @@ void RogueAdv_DebugExecuteRandomNextNode()
 #endif
 }
 
-static void AllocAdvPathScratch(void)
+// The scratch is only needed while a path is generated, which all happens in one go,
+// so it lives on the generating function's stack
+static void BeginAdvPathScratch(struct AdvMapScratch* scratch)
 {
     AGB_ASSERT(gAdvPathScratch == NULL);
-    gAdvPathScratch = AllocZeroed(sizeof(struct AdvMapScratch));
+    memset(scratch, 0, sizeof(struct AdvMapScratch));
+    gAdvPathScratch = scratch;
 }
 
-static void FreeAdvPathScratch(void)
+static void EndAdvPathScratch(void)
 {
     AGB_ASSERT(gAdvPathScratch != NULL);
-    free(gAdvPathScratch);
     gAdvPathScratch = NULL;
 }
 
@@ -17,6 +17,7 @@
 #include "field_screen_effect.h"
 #include "field_weather.h"
 #include "intro.h"
+#include "item.h"
 #include "main.h"
 #include "overworld.h"
 #include "pokemon.h"
@@ -24,9 +25,73 @@
 #include "rogue_automation.h"
 #include "rogue_adventurepaths.h"
 #include "rogue_controller.h"
+#include "rogue_quest.h"
 
 #define COMM_BUFFER_SIZE 32
 
+// Bump whenever the snapshot layout or the meaning of a section changes
+#define SNAPSHOT_MAGIC 0x50414E53 // "SNAP"
+#define SNAPSHOT_VERSION 1
+
+#define SNAPSHOT_BAG_SLOTS (BAG_ITEMS_COUNT + BAG_KEYITEMS_COUNT + BAG_POKEBALLS_COUNT + BAG_TMHM_COUNT + BAG_BERRIES_COUNT)
+
+// The host diff tool names sections by index, so only ever append to this
+enum
+{
+    SNAPSHOT_SECTION_SEED,
+    SNAPSHOT_SECTION_RUN,
+    SNAPSHOT_SECTION_ADV_PATH,
+    SNAPSHOT_SECTION_GLOBAL,
+    SNAPSHOT_SECTION_PARTY,
+    SNAPSHOT_SECTION_BAG,
+    SNAPSHOT_SECTION_FLAGS,
+    SNAPSHOT_SECTION_VARS,
+    SNAPSHOT_SECTION_COUNT
+};
+
+struct SnapshotSection
+{
+    u16 offset;
+    u16 size;
+};
+
+struct SnapshotHeader
+{
+    u32 magic;
+    u16 version;
+    u16 sectionCount;
+    struct SnapshotSection sections[SNAPSHOT_SECTION_COUNT];
+};
+
+// Everything needed to resume a run without replaying it. Bag quantities are
+// stored decrypted, so a snapshot can be loaded over any save file.
+struct RogueSnapshot
+{
+    struct SnapshotHeader header;
+    u16 rngSeed[2];
+    struct RogueRunData runData;
+    struct RogueAdvPath advPath;
+    struct RogueGlobalData globalData;
+    struct Pokemon party[PARTY_SIZE];
+    struct ItemSlot bag[SNAPSHOT_BAG_SLOTS];
+    u8 flags[NUM_FLAG_BYTES];
+    u16 vars[VARS_COUNT];
+};
+
+#define SNAPSHOT_SECTION(field) { offsetof(struct RogueSnapshot, field), sizeof(((struct RogueSnapshot *)0)->field) }
+
+static const struct SnapshotSection sSnapshotSections[SNAPSHOT_SECTION_COUNT] =
+{
+    [SNAPSHOT_SECTION_SEED] = SNAPSHOT_SECTION(rngSeed),
+    [SNAPSHOT_SECTION_RUN] = SNAPSHOT_SECTION(runData),
+    [SNAPSHOT_SECTION_ADV_PATH] = SNAPSHOT_SECTION(advPath),
+    [SNAPSHOT_SECTION_GLOBAL] = SNAPSHOT_SECTION(globalData),
+    [SNAPSHOT_SECTION_PARTY] = SNAPSHOT_SECTION(party),
+    [SNAPSHOT_SECTION_BAG] = SNAPSHOT_SECTION(bag),
+    [SNAPSHOT_SECTION_FLAGS] = SNAPSHOT_SECTION(flags),
+    [SNAPSHOT_SECTION_VARS] = SNAPSHOT_SECTION(vars),
+};
+
 struct AutomationState
 {
     u16 commandCounter;
@@ -36,16 +101,20 @@ struct AutomationState
 };
 
 EWRAM_DATA struct AutomationState gAutomationState;
+EWRAM_DATA static struct RogueSnapshot sSnapshot;
 
 const struct RogueAutomationHeader gRogueAutomationHeader =
 {
     .commBufferCapacity = COMM_BUFFER_SIZE,
     .commBuffer = gAutomationState.commBuffer,
+    .snapshotSize = sizeof(sSnapshot),
+    .snapshot = &sSnapshot,
 };
 
 void DoSpecialTrainerBattle(void);
 void ApplyMonPreset(struct Pokemon* mon, u8 level, const struct RogueMonPreset* preset);
 bool8 SelectNextPreset(u16 species, u16 trainerNum, u8 monIdx, u16 randFlag, struct RogueMonPreset* outPreset);
+void Rogue_AutomationApplySaveMigrations(u16 saveVersion, u16 compatVersion, u16 migrationLevel, u16* outFirstStep, u16* outChangedSteps);
 
 static void ProcessNextAutoCmd(u16 cmd, u16* args);
 static void AutoCmd_ClearPlayerParty(u16* args);
@@ -75,6 +144,9 @@ static void AutoCmd_Warp(u16* args);
 static void AutoCmd_WarpNextAdventureEncounter(u16* args);
 static void AutoCmd_SetAutomationFlag(u16* args);
 static void AutoCmd_GetAutomationFlag(u16* args);
+static void AutoCmd_SaveSnapshot(u16* args);
+static void AutoCmd_LoadSnapshot(u16* args);
+static void AutoCmd_ApplySaveMigrations(u16* args);
 
 
 u16 Rogue_AutomationBufferSize(void)
@@ -188,6 +260,9 @@ static void ProcessNextAutoCmd(u16 cmd, u16* args)
         case 24: AutoCmd_WarpNextAdventureEncounter(args); break;
         case 25: AutoCmd_SetAutomationFlag(args); break;
         case 26: AutoCmd_GetAutomationFlag(args); break;
+        case 27: AutoCmd_SaveSnapshot(args); break;
+        case 28: AutoCmd_LoadSnapshot(args); break;
+        case 29: AutoCmd_ApplySaveMigrations(args); break;
     }
 }
 
@@ -428,4 +503,99 @@ static void AutoCmd_GetAutomationFlag(u16* args)
     args[0] = Rogue_AutomationGetFlag(flag);
 }
 
-#endif
\ No newline at end of file
+static void AutoCmd_ApplySaveMigrations(u16* args)
+{
+    u16 saveVersion = args[0];
+    u16 compatVersion = args[1];
+    u16 migrationLevel = args[2];
+
+    Rogue_AutomationApplySaveMigrations(saveVersion, compatVersion, migrationLevel, &args[0], &args[1]);
+    args[2] = gSaveBlock1Ptr->rogueMigrationLevel;
+}
+
+// Snapshots
+//
+static void SaveSnapshotBag(void)
+{
+    u16 i, j;
+    struct ItemSlot* slot = &sSnapshot.bag[0];
+
+    for(i = 0; i < POCKETS_COUNT; ++i)
+    {
+        for(j = 0; j < gBagPockets[i].capacity; ++j, ++slot)
+        {
+            slot->itemId = gBagPockets[i].itemSlots[j].itemId;
+            slot->quantity = GetBagItemQuantity(&gBagPockets[i].itemSlots[j].quantity);
+        }
+    }
+}
+
+static void LoadSnapshotBag(void)
+{
+    u16 i, j;
+    const struct ItemSlot* slot = &sSnapshot.bag[0];
+
+    for(i = 0; i < POCKETS_COUNT; ++i)
+    {
+        for(j = 0; j < gBagPockets[i].capacity; ++j, ++slot)
+        {
+            gBagPockets[i].itemSlots[j].itemId = slot->itemId;
+            SetBagItemQuantity(&gBagPockets[i].itemSlots[j].quantity, slot->quantity);
+        }
+    }
+
+    InvalidateBagItemIndex();
+}
+
+static void AutoCmd_SaveSnapshot(u16* args)
+{
+    sSnapshot.header.magic = SNAPSHOT_MAGIC;
+    sSnapshot.header.version = SNAPSHOT_VERSION;
+    sSnapshot.header.sectionCount = SNAPSHOT_SECTION_COUNT;
+    memcpy(sSnapshot.header.sections, sSnapshotSections, sizeof(sSnapshotSections));
+
+    sSnapshot.rngSeed[0] = gSaveBlock1Ptr->dewfordTrends[0].words[0];
+    sSnapshot.rngSeed[1] = gSaveBlock1Ptr->dewfordTrends[0].words[1];
+    sSnapshot.runData = gRogueRun;
+    sSnapshot.advPath = gRogueAdvPath;
+    sSnapshot.globalData = gRogueGlobalData;
+    memcpy(sSnapshot.party, gPlayerParty, sizeof(sSnapshot.party));
+    SaveSnapshotBag();
+    memcpy(sSnapshot.flags, gSaveBlock1Ptr->flags, sizeof(sSnapshot.flags));
+    memcpy(sSnapshot.vars, gSaveBlock1Ptr->vars, sizeof(sSnapshot.vars));
+
+    args[0] = sizeof(sSnapshot);
+}
+
+// The host writes a snapshot over sSnapshot first. Snapshots from a build with
+// a different layout are rejected rather than partially applied.
+static void AutoCmd_LoadSnapshot(u16* args)
+{
+    if(sSnapshot.header.magic != SNAPSHOT_MAGIC
+    || sSnapshot.header.version != SNAPSHOT_VERSION
+    || sSnapshot.header.sectionCount != SNAPSHOT_SECTION_COUNT
+    || memcmp(sSnapshot.header.sections, sSnapshotSections, sizeof(sSnapshotSections)) != 0)
+    {
+        DebugPrint("Snapshot doesn't match this build");
+        args[0] = FALSE;
+        return;
+    }
+
+    gSaveBlock1Ptr->dewfordTrends[0].words[0] = sSnapshot.rngSeed[0];
+    gSaveBlock1Ptr->dewfordTrends[0].words[1] = sSnapshot.rngSeed[1];
+    gRogueRun = sSnapshot.runData;
+    gRogueAdvPath = sSnapshot.advPath;
+    gRogueGlobalData = sSnapshot.globalData;
+    memcpy(gPlayerParty, sSnapshot.party, sizeof(sSnapshot.party));
+    CalculatePlayerPartyCount();
+    LoadSnapshotBag();
+    memcpy(gSaveBlock1Ptr->flags, sSnapshot.flags, sizeof(sSnapshot.flags));
+    memcpy(gSaveBlock1Ptr->vars, sSnapshot.vars, sizeof(sSnapshot.vars));
+
+    // Quest states were replaced wholesale
+    InvalidateQuestMasks();
+
+    args[0] = TRUE;
+}
+
+#endif
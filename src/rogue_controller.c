@@ -44,6 +44,7 @@
 #include "rogue_charms.h"
 #include "rogue_controller.h"
 #include "rogue_popup.h"
+#include "rogue_profiler.h"
 #include "rogue_query.h"
 #include "rogue_quest.h"
 
@@ -75,6 +76,12 @@ extern const u8 gText_RogueDebug_AdvHeader[];
 extern const u8 gText_RogueDebug_AdvCount[];
 extern const u8 gText_RogueDebug_X[];
 extern const u8 gText_RogueDebug_Y[];
+
+#ifdef ROGUE_FEATURE_PROFILER
+extern const u8 gText_RogueDebug_ProfileHeader[];
+extern const u8 gText_RogueDebug_ProfileFrame[];
+extern const u8* const gText_RogueDebug_ProfileSections[];
+#endif
 #endif
 
 #define LAB_MON_COUNT 3
@@ -1130,6 +1137,18 @@ bool8 Rogue_ShouldShowMiniMenu(void)
     return TRUE;
 }
 
+#ifdef ROGUE_FEATURE_PROFILER
+#define DEBUG_TAB_PROFILER 3
+#define DEBUG_TAB_COUNT 4
+
+static u32 ProfileTicksToPercent(u16 ticks)
+{
+    return ((u32)ticks * PROFILE_TICK_CYCLES * 100) / PROFILE_FRAME_CYCLES;
+}
+#else
+#define DEBUG_TAB_COUNT 3
+#endif
+
 static u8* AppendNumberField(u8* strPointer, const u8* field, u32 num)
 {
     u8 pow = 2;
@@ -1154,7 +1173,7 @@ u8* Rogue_GetMiniMenuContent(void)
     u8* strPointer = &gStringVar4[0];
     *strPointer = EOS;
 
-    if(JOY_NEW(R_BUTTON) && gDebug_CurrentTab != 2)
+    if(JOY_NEW(R_BUTTON) && gDebug_CurrentTab != DEBUG_TAB_COUNT - 1)
     {
         ++gDebug_CurrentTab;
     }
@@ -1196,6 +1215,26 @@ u8* Rogue_GetMiniMenuContent(void)
         strPointer = AppendNumberField(strPointer, gText_RogueDebug_X, gRogueAdvPath.currentNodeX);
         strPointer = AppendNumberField(strPointer, gText_RogueDebug_Y, gRogueAdvPath.currentNodeY);
     }
+#ifdef ROGUE_FEATURE_PROFILER
+    // Profiler tab
+    // Worst frame since the tab was last shown, as a percentage of the frame budget
+    //
+    else if(gDebug_CurrentTab == DEBUG_TAB_PROFILER)
+    {
+        const struct RogueProfilerFrame* frame = Rogue_ProfilerGetPeakFrame();
+        u8 i;
+
+        strPointer = StringAppend(strPointer, gText_RogueDebug_ProfileHeader);
+        strPointer = AppendNumberField(strPointer, gText_RogueDebug_ProfileFrame, ProfileTicksToPercent(frame->frameTicks));
+
+        for(i = 0; i < PROFILE_SECTION_COUNT; ++i)
+        {
+            strPointer = AppendNumberField(strPointer, gText_RogueDebug_ProfileSections[i], ProfileTicksToPercent(frame->sectionTicks[i]));
+        }
+
+        Rogue_ProfilerResetPeak();
+    }
+#endif
 #ifdef ROGUE_FEATURE_AUTOMATION
     // Automation tab
     //
@@ -1387,7 +1426,7 @@ static void SelectStartMons(void)
 #endif
 }
 
-#define ROGUE_SAVE_VERSION 4    // The version to use for tracking/updating internal save game data
+#define ROGUE_SAVE_VERSION 5    // The version to use for tracking/updating internal save game data
 // ROGUE_COMPAT_VERSION moved to constants/rogue.h
 
 static bool8 IsPreReleaseCompatVersion(u16 version)
@@ -1401,22 +1440,20 @@ static bool8 IsPreReleaseCompatVersion(u16 version)
     return FALSE;
 }
 
-static void ClearPokemonHeldItems(void)
+static void ClearBoxMonHeldItem(struct BoxMonView *view, u8 boxId, u8 boxPosition)
 {
-    struct BoxPokemon* boxMon;
-    u16 boxId, boxPosition;
     u16 itemId = ITEM_NONE;
 
-    for (boxId = 0; boxId < TOTAL_BOXES_COUNT; boxId++)
-    {
-        for (boxPosition = 0; boxPosition < IN_BOX_COUNT; boxPosition++)
-        {
-            boxMon = GetBoxedMonPtr(boxId, boxPosition);
+    if(GetBoxMonViewData(view, MON_DATA_HELD_ITEM, NULL) != ITEM_NONE)
+        SetBoxMonViewData(view, MON_DATA_HELD_ITEM, &itemId);
+}
 
-            if(GetBoxMonData(boxMon, MON_DATA_SPECIES) != SPECIES_NONE)
-                SetBoxMonData(boxMon, MON_DATA_HELD_ITEM, &itemId);
-        }
-    }
+static void ClearPokemonHeldItems(void)
+{
+    u16 boxId;
+    u16 itemId = ITEM_NONE;
+
+    ForEachStorageMon(ClearBoxMonHeldItem);
 
     for(boxId = 0; boxId < gPlayerPartyCount; ++boxId)
     {
@@ -1425,50 +1462,125 @@ static void ClearPokemonHeldItems(void)
     }
 }
 
-// Called on NewGame and LoadGame, if new values are added in new releases, put them here
-static void EnsureLoadValuesAreValid(bool8 newGame, u16 saveVersion)
+// Save migrations
+//
+// Each step runs exactly once per save, in table order. The number of steps
+// already applied is stored in rogueMigrationLevel, so a save that is up to date
+// skips all of them. Only ever append to sSaveMigrations.
+//
+// Saves from before ROGUE_SAVE_VERSION 5 didn't record a level, so they start
+// from 0 and the steps that predate this table check the old version fields to
+// decide whether they apply. Each step returns whether it changed the save.
+
+static bool8 Migration_SoftResetPre_1_2(void)
 {
-    // Loading existing save
-    if(!newGame)
-    {
-        if(saveVersion == 0 || saveVersion == 1)
-        {
-            // Soft reset for Quest update (Old save and Pre-release saves)
-            FlagClear(FLAG_ROGUE_UNCOVERRED_POKABBIE);
-            FlagClear(FLAG_ROGUE_MET_POKABBIE);
-            FlagClear(FLAG_IS_CHAMPION);
+    // Soft reset for Quest update (Old save and Pre-release saves)
+    if(gSaveBlock1Ptr->rogueSaveVersion > 1)
+        return FALSE;
 
-            VarSet(VAR_ROGUE_ENABLED_GEN_LIMIT, 3);
-            VarSet(VAR_ROGUE_FURTHEST_DIFFICULTY, 0);
-            VarSet(VAR_ROGUE_ADVENTURE_MONEY, 0);
+    FlagClear(FLAG_ROGUE_UNCOVERRED_POKABBIE);
+    FlagClear(FLAG_ROGUE_MET_POKABBIE);
+    FlagClear(FLAG_IS_CHAMPION);
 
-            ClearBerryTrees();
-            SetMoney(&gSaveBlock1Ptr->money, 0);
-            gSaveBlock1Ptr->registeredItem = 0;
-            ClearBag();
-            NewGameInitPCItems();
-            ClearPokemonHeldItems();
-            AddBagItem(ITEM_POKE_BALL, 5);
-            AddBagItem(ITEM_POTION, 1);
-        }
-    }
+    VarSet(VAR_ROGUE_ENABLED_GEN_LIMIT, 3);
+    VarSet(VAR_ROGUE_FURTHEST_DIFFICULTY, 0);
+    VarSet(VAR_ROGUE_ADVENTURE_MONEY, 0);
 
-    // v1.3 new values
-    if(newGame || saveVersion < 3)
-    {
-        VarSet(VAR_ROGUE_REGION_DEX_LIMIT, 0);
-        VarSet(VAR_ROGUE_DESIRED_CAMPAIGN, ROGUE_CAMPAIGN_NONE);
+    ClearBerryTrees();
+    SetMoney(&gSaveBlock1Ptr->money, 0);
+    gSaveBlock1Ptr->registeredItem = 0;
+    ClearBag();
+    NewGameInitPCItems();
+    ClearPokemonHeldItems();
+    AddBagItem(ITEM_POKE_BALL, 5);
+    AddBagItem(ITEM_POTION, 1);
+    return TRUE;
+}
 
-        FlagSet(FLAG_ROGUE_HOENN_ROUTES);
-        FlagSet(FLAG_ROGUE_HOENN_BOSSES);
+static void SetDefaultValues_1_3(void)
+{
+    VarSet(VAR_ROGUE_REGION_DEX_LIMIT, 0);
+    VarSet(VAR_ROGUE_DESIRED_CAMPAIGN, ROGUE_CAMPAIGN_NONE);
+
+    FlagSet(FLAG_ROGUE_HOENN_ROUTES);
+    FlagSet(FLAG_ROGUE_HOENN_BOSSES);
+
+    FlagSet(FLAG_ROGUE_KANTO_ROUTES);
+    FlagSet(FLAG_ROGUE_JOHTO_ROUTES);
 
-        FlagSet(FLAG_ROGUE_KANTO_ROUTES);
-        FlagSet(FLAG_ROGUE_JOHTO_ROUTES);
+    FlagClear(FLAG_ROGUE_KANTO_BOSSES);
+    FlagClear(FLAG_ROGUE_JOHTO_BOSSES);
+}
 
-        FlagClear(FLAG_ROGUE_KANTO_BOSSES);
-        FlagClear(FLAG_ROGUE_JOHTO_BOSSES);
+static bool8 Migration_AddValues_1_3(void)
+{
+    if(gSaveBlock1Ptr->rogueSaveVersion >= 3)
+        return FALSE;
+
+    SetDefaultValues_1_3();
+    return TRUE;
+}
+
+static bool8 Migration_FixQuests_1_3_1(void)
+{
+    if(gSaveBlock1Ptr->rogueCompatVersion != 4)
+        return FALSE;
+
+    ResetQuestsFor_1_3_1();
+    return TRUE;
+}
+
+static bool8 (*const sSaveMigrations[])(void) =
+{
+    Migration_SoftResetPre_1_2,
+    Migration_AddValues_1_3,
+    Migration_FixQuests_1_3_1,
+};
+
+// The first step the loaded save hasn't had yet
+static u16 GetFirstPendingSaveMigration(void)
+{
+    if(gSaveBlock1Ptr->rogueSaveVersion < 5)
+        return 0;
+
+    return gSaveBlock1Ptr->rogueMigrationLevel;
+}
+
+// Returns a bit for each step that changed the save
+static u16 ApplySaveMigrations(void)
+{
+    u16 level;
+    u16 changedSteps = 0;
+
+    for(level = GetFirstPendingSaveMigration(); level < ARRAY_COUNT(sSaveMigrations); ++level)
+    {
+        DebugPrintf("Applying save migration %d", level);
+
+        if(sSaveMigrations[level]())
+            changedSteps |= (1 << level);
     }
 
+    gSaveBlock1Ptr->rogueMigrationLevel = level;
+    return changedSteps;
+}
+
+#ifdef ROGUE_FEATURE_AUTOMATION
+// Runs the migration table over the current save as if it had been loaded with
+// the given version fields, so the automation harness can check old saves
+void Rogue_AutomationApplySaveMigrations(u16 saveVersion, u16 compatVersion, u16 migrationLevel, u16* outFirstStep, u16* outChangedSteps)
+{
+    gSaveBlock1Ptr->rogueSaveVersion = saveVersion;
+    gSaveBlock1Ptr->rogueCompatVersion = compatVersion;
+    gSaveBlock1Ptr->rogueMigrationLevel = migrationLevel;
+
+    *outFirstStep = GetFirstPendingSaveMigration();
+    *outChangedSteps = ApplySaveMigrations();
+}
+#endif
+
+// Called on NewGame and LoadGame, after any migrations
+static void EnsureLoadValuesAreValid(void)
+{
 #ifdef ROGUE_DEBUG
     FlagClear(FLAG_ROGUE_DEBUG_DISABLED);
 #else
@@ -1553,7 +1665,11 @@ void Rogue_OnNewGame(void)
     ResetQuestStateAfter(0);
     Rogue_ResetCampaignAfter(0);
 
-    EnsureLoadValuesAreValid(TRUE, ROGUE_SAVE_VERSION);
+    // A new game starts with every migration already applied
+    SetDefaultValues_1_3();
+    gSaveBlock1Ptr->rogueMigrationLevel = ARRAY_COUNT(sSaveMigrations);
+
+    EnsureLoadValuesAreValid();
 
     Rogue_ClearPopupQueue();
 
@@ -1647,14 +1763,26 @@ static void FlipEncryptMemory(void* ptr, size_t size, u32 encryptionKey)
     if(encryptionKey)
     {
         size_t i;
-        u8* write;
+        size_t wordsEnd;
+        u32 wordKey;
+        u8* bytes = (u8*)ptr;
         u8* encryptionBytes = (u8*)&encryptionKey;
 
-        for(i = 0; i < size; ++i)
-        {
-            write = (u8*)(ptr) + i;
-            *write = *write ^ encryptionBytes[i % 4];
-        }
+        // Byte i is always flipped by key byte i % 4, whatever the alignment
+        for(i = 0; i < size && ((u32)(bytes + i) & 3) != 0; ++i)
+            bytes[i] ^= encryptionBytes[i % 4];
+
+        // Rotate the key so it lines up with the word boundary
+        wordKey = encryptionKey;
+        if(i % 4)
+            wordKey = (encryptionKey >> (8 * (i % 4))) | (encryptionKey << (32 - 8 * (i % 4)));
+
+        wordsEnd = i + ((size - i) & ~3);
+        for(; i < wordsEnd; i += 4)
+            *(u32*)(bytes + i) ^= wordKey;
+
+        for(; i < size; ++i)
+            bytes[i] ^= encryptionBytes[i % 4];
     }
 }
 
@@ -1925,12 +2053,10 @@ void Rogue_OnLoadGame(void)
 
         if(IsPreReleaseCompatVersion(gSaveBlock1Ptr->rogueCompatVersion))
             FlagSet(FLAG_ROGUE_PRE_RELEASE_COMPAT_WARNING);
-
-        if(gSaveBlock1Ptr->rogueCompatVersion == 4)
-            ResetQuestsFor_1_3_1();
     }
 
-    EnsureLoadValuesAreValid(FALSE, gSaveBlock1Ptr->rogueSaveVersion);
+    ApplySaveMigrations();
+    EnsureLoadValuesAreValid();
     RecalcCharmCurseValues();
 }
 
@@ -2023,6 +2149,10 @@ void Rogue_MainInit(void)
 {
     ResetHotTracking();
 
+#ifdef ROGUE_FEATURE_PROFILER
+    Rogue_ProfilerInit();
+#endif
+
 #ifdef ROGUE_FEATURE_AUTOMATION
     Rogue_AutomationInit();
 #endif
@@ -3671,9 +3801,10 @@ const u16 gNatureEvRewardStatTable[NUM_NATURES][NUM_STATS] =
 // Award EVs based on nature
 static void MonGainRewardEVs(struct Pokemon *mon)
 {
+    struct BoxMonView view;
     u8 evs[NUM_STATS];
     u16 evIncrease;
-    u16 totalEVs;
+    u16 totalEVs = 0;
     u16 heldItem;
     u8 holdEffect;
     int i, multiplier;
@@ -3681,7 +3812,8 @@ static void MonGainRewardEVs(struct Pokemon *mon)
     u8 bonus;
     u8 nature;
 
-    heldItem = GetMonData(mon, MON_DATA_HELD_ITEM, 0);
+    OpenBoxMonView(&view, &mon->box);
+    heldItem = GetBoxMonViewData(&view, MON_DATA_HELD_ITEM, NULL);
     nature = GetNature(mon);
 
     if (heldItem == ITEM_ENIGMA_BERRY)
@@ -3701,7 +3833,7 @@ static void MonGainRewardEVs(struct Pokemon *mon)
 
     for (i = 0; i < NUM_STATS; i++)
     {
-        evs[i] = GetMonData(mon, MON_DATA_HP_EV + i, 0);
+        evs[i] = GetBoxMonViewData(&view, MON_DATA_HP_EV + i, NULL);
         totalEVs += evs[i];
     }
 
@@ -3742,8 +3874,10 @@ static void MonGainRewardEVs(struct Pokemon *mon)
 
         evs[i] += evIncrease;
         totalEVs += evIncrease;
-        SetMonData(mon, MON_DATA_HP_EV + i, &evs[i]);
+        SetBoxMonViewData(&view, MON_DATA_HP_EV + i, &evs[i]);
     }
+
+    CommitBoxMonView(&view);
 }
 
 
@@ -4877,11 +5011,33 @@ static void SwapMonItems(u8 aIdx, u8 bIdx, struct Pokemon *party)
 }
 
 // + go to the front - go to the back
+static bool8 MovesContain(const u16 *moves, u16 move)
+{
+    u8 i;
+
+    for (i = 0; i < MAX_MON_MOVES; i++)
+    {
+        if (moves[i] == move)
+            return TRUE;
+    }
+    return FALSE;
+}
+
 s16 CalulcateMonSortScore(struct Pokemon* mon)
 {
+    struct BoxMonView view;
+    u16 moves[MAX_MON_MOVES];
     s16 score = 0;
-    u16 species = GetMonData(mon, MON_DATA_SPECIES);
-    u16 item = GetMonData(mon, MON_DATA_HELD_ITEM);
+    u16 species;
+    u16 item;
+    u8 i;
+
+    OpenBoxMonView(&view, &mon->box);
+    species = GetBoxMonViewData(&view, MON_DATA_SPECIES, NULL);
+    item = GetBoxMonViewData(&view, MON_DATA_HELD_ITEM, NULL);
+
+    for (i = 0; i < MAX_MON_MOVES; i++)
+        moves[i] = GetBoxMonViewData(&view, MON_DATA_MOVE1 + i, NULL);
 
 #ifdef ROGUE_EXPANSION
     if(((item >= ITEM_VENUSAURITE && item <= ITEM_DIANCITE) || (item >= ITEM_NORMALIUM_Z && item <= ITEM_ULTRANECROZIUM_Z)))
@@ -4897,86 +5053,86 @@ s16 CalulcateMonSortScore(struct Pokemon* mon)
 
     // Early pri moves
     //
-    if(MonKnowsMove(mon, MOVE_FAKE_OUT))
+    if(MovesContain(moves, MOVE_FAKE_OUT))
     {
         score += 1;
     }
-    if(MonKnowsMove(mon, MOVE_LIGHT_SCREEN))
+    if(MovesContain(moves, MOVE_LIGHT_SCREEN))
     {
         score += 1;
     }
-    if(MonKnowsMove(mon, MOVE_REFLECT))
+    if(MovesContain(moves, MOVE_REFLECT))
     {
         score += 1;
     }
-    if(MonKnowsMove(mon, MOVE_SPIKES))
+    if(MovesContain(moves, MOVE_SPIKES))
     {
         score += 1;
     }
 
-    if(MonKnowsMove(mon, MOVE_TAUNT))
+    if(MovesContain(moves, MOVE_TAUNT))
     {
         score += 1;
     }
 
-    if(MonKnowsMove(mon, MOVE_TRICK))
+    if(MovesContain(moves, MOVE_TRICK))
     {
         score += 1;
     }
 
-    if(MonKnowsMove(mon, MOVE_TOXIC))
+    if(MovesContain(moves, MOVE_TOXIC))
     {
         score += 1;
     }
 
-    if(MonKnowsMove(mon, MOVE_BATON_PASS))
+    if(MovesContain(moves, MOVE_BATON_PASS))
     {
         score += 1;
 
         // Only prioritse sub if we want to baton pass out
-        if(MonKnowsMove(mon, MOVE_SUBSTITUTE))
+        if(MovesContain(moves, MOVE_SUBSTITUTE))
         {
             score += 1;
         }
     }
 
 #ifdef ROGUE_EXPANSION
-    if(MonKnowsMove(mon, MOVE_U_TURN))
+    if(MovesContain(moves, MOVE_U_TURN))
     {
         score += 1;
     }
 
-    if(MonKnowsMove(mon, MOVE_FLIP_TURN))
+    if(MovesContain(moves, MOVE_FLIP_TURN))
     {
         score += 1;
     }
 
-    if(MonKnowsMove(mon, MOVE_PARTING_SHOT))
+    if(MovesContain(moves, MOVE_PARTING_SHOT))
     {
         score += 1;
     }
 
-    if(MonKnowsMove(mon, MOVE_VOLT_SWITCH))
+    if(MovesContain(moves, MOVE_VOLT_SWITCH))
     {
         score += 1;
     }
 
-    if(MonKnowsMove(mon, MOVE_TOXIC_SPIKES))
+    if(MovesContain(moves, MOVE_TOXIC_SPIKES))
     {
         score += 1;
     }
 
-    if(MonKnowsMove(mon, MOVE_STEALTH_ROCK))
+    if(MovesContain(moves, MOVE_STEALTH_ROCK))
     {
         score += 1;
     }
 
-    if(MonKnowsMove(mon, MOVE_STICKY_WEB))
+    if(MovesContain(moves, MOVE_STICKY_WEB))
     {
         score += 1;
     }
 
-    if(MonKnowsMove(mon, MOVE_TRICK_ROOM))
+    if(MovesContain(moves, MOVE_TRICK_ROOM))
     {
         score += 1;
     }
@@ -5504,13 +5660,16 @@ bool8 SelectNextPreset(u16 species, u16 trainerNum, u8 monIdx, u16 randFlag, str
 
     if(exactMirrorPlayer)
     {
+        struct BoxMonView view;
+
         // Populate mon preset based on exact same team
-        outPreset->heldItem = GetMonData(&gPlayerParty[monIdx], MON_DATA_HELD_ITEM);
-        outPreset->abilityNum = GetMonData(&gPlayerParty[monIdx], MON_DATA_ABILITY_NUM);
+        OpenBoxMonView(&view, &gPlayerParty[monIdx].box);
+        outPreset->heldItem = GetBoxMonViewData(&view, MON_DATA_HELD_ITEM, NULL);
+        outPreset->abilityNum = GetBoxMonViewData(&view, MON_DATA_ABILITY_NUM, NULL);
 
         for(i = 0; i < MAX_MON_MOVES; ++i)
         {
-            outPreset->moves[i] = GetMonData(&gPlayerParty[monIdx], MON_DATA_MOVE1 + i);
+            outPreset->moves[i] = GetBoxMonViewData(&view, MON_DATA_MOVE1 + i, NULL);
         }
 
         return TRUE;
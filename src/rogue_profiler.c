@@ -0,0 +1,117 @@
+#include "global.h"
+
+#ifdef ROGUE_FEATURE_PROFILER
+#include "gba/isagbprint.h"
+
+#include "rogue_profiler.h"
+
+struct ProfilerState
+{
+    u32 frameCount;
+    u16 frameStart;
+    u16 sectionStart[PROFILE_SECTION_COUNT];
+    struct RogueProfilerFrame current;
+    struct RogueProfilerFrame peak;
+    struct RogueProfilerFrame frames[PROFILE_TRACE_CAPACITY];
+};
+
+EWRAM_DATA static struct ProfilerState sProfilerState = {0};
+
+const struct RogueProfilerHeader gRogueProfilerHeader =
+{
+    .frameCapacity = PROFILE_TRACE_CAPACITY,
+    .sectionCount = PROFILE_SECTION_COUNT,
+    .tickCycles = PROFILE_TICK_CYCLES,
+    .frames = sProfilerState.frames,
+    .frameCount = &sProfilerState.frameCount,
+};
+
+static const char *const sSectionNames[PROFILE_SECTION_COUNT] =
+{
+    [PROFILE_SECTION_TASKS] = "tasks",
+    [PROFILE_SECTION_ANIMATE_SPRITES] = "anim",
+    [PROFILE_SECTION_BUILD_OAM] = "oam",
+    [PROFILE_SECTION_PALETTE_FADE] = "fade",
+    [PROFILE_SECTION_SCRIPT] = "script",
+    [PROFILE_SECTION_TRAINER_PARTY] = "party",
+    [PROFILE_SECTION_ADVENTURE_PATHS] = "advpath",
+};
+
+static u16 ReadTicks(void)
+{
+    return REG_TM2CNT_L;
+}
+
+void Rogue_ProfilerInit(void)
+{
+    CpuFill32(0, &sProfilerState, sizeof(sProfilerState));
+
+    // Free running, so differences are correct across the 16 bit wrap.
+    REG_TM2CNT_H = 0;
+    REG_TM2CNT_L = 0;
+    REG_TM2CNT_H = TIMER_ENABLE | TIMER_64CLK;
+}
+
+void Rogue_ProfilerBeginFrame(void)
+{
+    sProfilerState.frameStart = ReadTicks();
+}
+
+static void PrintSlowFrame(const struct RogueProfilerFrame *frame)
+{
+    u8 i;
+
+    DebugPrintf("Slow frame %d: %d cycles", sProfilerState.frameCount, frame->frameTicks * PROFILE_TICK_CYCLES);
+
+    for (i = 0; i < PROFILE_SECTION_COUNT; i++)
+    {
+        if (frame->sectionTicks[i] != 0)
+            DebugPrintf("  %s: %d", sSectionNames[i], frame->sectionTicks[i] * PROFILE_TICK_CYCLES);
+    }
+}
+
+// Called once the frame's work is done, before waiting for VBlank.
+void Rogue_ProfilerEndFrame(void)
+{
+    struct RogueProfilerFrame *frame = &sProfilerState.current;
+
+    frame->frameTicks = ReadTicks() - sProfilerState.frameStart;
+
+    sProfilerState.frames[sProfilerState.frameCount % PROFILE_TRACE_CAPACITY] = *frame;
+    sProfilerState.frameCount++;
+
+    if (frame->frameTicks > sProfilerState.peak.frameTicks)
+        sProfilerState.peak = *frame;
+
+    if (frame->frameTicks * PROFILE_TICK_CYCLES > PROFILE_FRAME_CYCLES)
+        PrintSlowFrame(frame);
+
+    CpuFill16(0, frame, sizeof(*frame));
+}
+
+void Rogue_ProfilerBegin(u8 section)
+{
+    sProfilerState.sectionStart[section] = ReadTicks();
+}
+
+void Rogue_ProfilerEnd(u8 section)
+{
+    sProfilerState.current.sectionTicks[section] += (u16)(ReadTicks() - sProfilerState.sectionStart[section]);
+}
+
+const struct RogueProfilerFrame *Rogue_ProfilerGetLastFrame(void)
+{
+    return &sProfilerState.frames[(sProfilerState.frameCount - 1) % PROFILE_TRACE_CAPACITY];
+}
+
+const struct RogueProfilerFrame *Rogue_ProfilerGetPeakFrame(void)
+{
+    return &sProfilerState.peak;
+}
+
+void Rogue_ProfilerResetPeak(void)
+{
+    CpuFill16(0, &sProfilerState.peak, sizeof(sProfilerState.peak));
+}
+
+#endif
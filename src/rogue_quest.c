@@ -30,6 +30,39 @@ static EWRAM_DATA u8 sPreviousRouteType = 0;
 
 typedef void (*QuestCallback)(u16 questId, struct RogueQuestState* state);
 
+#define QUEST_MASK_WORDS ((QUEST_CAPACITY + 31) / 32)
+#define QUEST_MASK_WORD(questId) ((questId) / 32)
+#define QUEST_MASK_BIT(questId) (1u << ((questId) % 32))
+
+// Notifications which check more than a single quest
+enum
+{
+    QUEST_EVENT_PARTY_CHECK,
+    QUEST_EVENT_BATTLE_END,
+    QUEST_EVENT_MON_FAINTED,
+    QUEST_EVENT_WARP,
+    QUEST_EVENT_COUNT
+};
+
+// One bit per quest for each state flag, so lookups and scans don't have to
+// read every state; counts are popcounts and "any" checks are word ORs.
+// Everything in this file that changes a quest's state keeps these in sync;
+// they're rebuilt from questStates after the table is loaded or reset.
+struct QuestMasks
+{
+    u32 unlocked[QUEST_MASK_WORDS];
+    u32 active[QUEST_MASK_WORDS];
+    u32 completed[QUEST_MASK_WORDS];
+    u32 pendingRewards[QUEST_MASK_WORDS];
+    u32 newMarker[QUEST_MASK_WORDS];
+    u32 hasUnlocks[QUEST_MASK_WORDS]; // Constant, from gRogueQuests
+    u32 activeEvents;
+    bool8 isValid;
+    bool8 activeEventsValid;
+};
+
+static EWRAM_DATA struct QuestMasks sQuestMasks = {0};
+
 static const u16 TypeToMonoQuest[NUMBER_OF_MON_TYPES] =
 {
     [TYPE_NORMAL] = QUEST_NORMAL_Champion,
@@ -55,6 +88,81 @@ static const u16 TypeToMonoQuest[NUMBER_OF_MON_TYPES] =
 #endif
 };
 
+// The quests each event's handler looks at, terminated by QUEST_NONE.
+// The handler is skipped entirely when none of these are active, so any
+// quest it checks must be listed here.
+static const u16 sPartyCheckSubscribers[] =
+{
+    QUEST_NORMAL_Champion,
+    QUEST_FIGHTING_Champion,
+    QUEST_FLYING_Champion,
+    QUEST_POISON_Champion,
+    QUEST_GROUND_Champion,
+    QUEST_ROCK_Champion,
+    QUEST_BUG_Champion,
+    QUEST_GHOST_Champion,
+    QUEST_STEEL_Champion,
+    QUEST_FIRE_Champion,
+    QUEST_WATER_Champion,
+    QUEST_GRASS_Champion,
+    QUEST_ELECTRIC_Champion,
+    QUEST_PSYCHIC_Champion,
+    QUEST_ICE_Champion,
+    QUEST_DRAGON_Champion,
+    QUEST_DARK_Champion,
+#ifdef ROGUE_EXPANSION
+    QUEST_FAIRY_Champion,
+#endif
+    QUEST_Hardcore3,
+    QUEST_Hardcore4,
+    QUEST_LegendOnly,
+    QUEST_ShinyOnly,
+    QUEST_NONE
+};
+
+static const u16 sBattleEndSubscribers[] =
+{
+    QUEST_Collector1,
+    QUEST_Collector2,
+    QUEST_NoFainting1,
+    QUEST_NONE
+};
+
+static const u16 sMonFaintedSubscribers[] =
+{
+    QUEST_NoFainting2,
+    QUEST_NoFainting3,
+    QUEST_WobFate,
+    QUEST_NONE
+};
+
+static const u16 sWarpSubscribers[] =
+{
+    QUEST_Bike1,
+    QUEST_Bike2,
+    QUEST_ChaosChampion,
+    QUEST_Nuzlocke,
+    QUEST_IronMono2,
+    QUEST_Hardcore4,
+    QUEST_OrreMode,
+#ifdef ROGUE_EXPANSION
+    QUEST_ShayminItem,
+    QUEST_HoopaItem,
+    QUEST_NatureItem,
+    QUEST_DeoxysItem,
+#endif
+    QUEST_BigSaver,
+    QUEST_NONE
+};
+
+static const u16 *const sQuestEventSubscribers[QUEST_EVENT_COUNT] =
+{
+    [QUEST_EVENT_PARTY_CHECK] = sPartyCheckSubscribers,
+    [QUEST_EVENT_BATTLE_END] = sBattleEndSubscribers,
+    [QUEST_EVENT_MON_FAINTED] = sMonFaintedSubscribers,
+    [QUEST_EVENT_WARP] = sWarpSubscribers,
+};
+
 bool8 IsSpeciesType(u16 species, u8 type);
 bool8 PartyContainsSpecies(struct Pokemon *party, u8 partyCount, u16 species);
 bool8 IsSpeciesLegendary(u16 species);
@@ -65,6 +173,96 @@ static void ForEachUnlockedQuest(QuestCallback callback);
 static void ActivateAdventureQuests(u16 questId, struct RogueQuestState* state);
 static void ActivateHubQuests(u16 questId, struct RogueQuestState* state);
 
+static void WriteQuestMaskBit(u32* mask, u16 questId, bool32 isSet)
+{
+    if(isSet)
+        mask[QUEST_MASK_WORD(questId)] |= QUEST_MASK_BIT(questId);
+    else
+        mask[QUEST_MASK_WORD(questId)] &= ~QUEST_MASK_BIT(questId);
+}
+
+static void WriteQuestMaskBits(u16 questId)
+{
+    struct RogueQuestState* state = &gRogueGlobalData.questStates[questId];
+    u32 prevActive = sQuestMasks.active[QUEST_MASK_WORD(questId)];
+
+    WriteQuestMaskBit(sQuestMasks.unlocked, questId, state->isUnlocked);
+    WriteQuestMaskBit(sQuestMasks.active, questId, state->isUnlocked && state->isValid);
+    WriteQuestMaskBit(sQuestMasks.completed, questId, state->isCompleted);
+    WriteQuestMaskBit(sQuestMasks.pendingRewards, questId, state->hasPendingRewards);
+    WriteQuestMaskBit(sQuestMasks.newMarker, questId, state->hasNewMarker);
+
+    if(sQuestMasks.active[QUEST_MASK_WORD(questId)] != prevActive)
+        sQuestMasks.activeEventsValid = FALSE;
+}
+
+static void EnsureQuestMasks(void)
+{
+    u16 i;
+
+    if(!sQuestMasks.isValid)
+    {
+        memset(&sQuestMasks, 0, sizeof(sQuestMasks));
+
+        for(i = 0; i < QUEST_CAPACITY; ++i)
+        {
+            WriteQuestMaskBits(i);
+            WriteQuestMaskBit(sQuestMasks.hasUnlocks, i, DoesQuestHaveUnlocks(i));
+        }
+
+        sQuestMasks.isValid = TRUE;
+    }
+}
+
+// Call after editing questStates directly, or replacing the table
+void InvalidateQuestMasks(void)
+{
+    sQuestMasks.isValid = FALSE;
+}
+
+// Call after changing a quest's state
+static void SyncQuestMask(u16 questId)
+{
+    // An invalid mask picks the change up when it's rebuilt
+    if(sQuestMasks.isValid)
+        WriteQuestMaskBits(questId);
+}
+
+static u32 CountMaskBits(u32 bits)
+{
+    bits = bits - ((bits >> 1) & 0x55555555);
+    bits = (bits & 0x33333333) + ((bits >> 2) & 0x33333333);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0F;
+    return (bits * 0x01010101) >> 24;
+}
+
+static bool8 IsQuestEventActive(u8 event)
+{
+    if(!sQuestMasks.activeEventsValid)
+    {
+        u8 i;
+        const u16* questId;
+
+        sQuestMasks.activeEvents = 0;
+
+        for(i = 0; i < QUEST_EVENT_COUNT; ++i)
+        {
+            for(questId = sQuestEventSubscribers[i]; *questId != QUEST_NONE; ++questId)
+            {
+                if(IsQuestActive(*questId))
+                {
+                    sQuestMasks.activeEvents |= (1 << i);
+                    break;
+                }
+            }
+        }
+
+        sQuestMasks.activeEventsValid = TRUE;
+    }
+
+    return (sQuestMasks.activeEvents & (1 << event)) != 0;
+}
+
 static void UnlockDefaultQuests()
 {
     u16 i;
@@ -97,6 +295,9 @@ void ResetQuestStateAfter(u16 loadedQuestCapacity)
 {
     u16 i;
 
+    // The table has just been loaded or reset
+    InvalidateQuestMasks();
+
     if(loadedQuestCapacity < QUEST_CAPACITY)
     {
         if(loadedQuestCapacity == 0)
@@ -132,71 +333,58 @@ void ResetQuestsFor_1_3_1(void)
     gRogueGlobalData.questStates[QUEST_IronMono2].hasPendingRewards = FALSE;
     gRogueGlobalData.questStates[QUEST_Hardcore4].isCompleted = FALSE;
     gRogueGlobalData.questStates[QUEST_Hardcore4].hasPendingRewards = FALSE;
+
+    InvalidateQuestMasks();
 }
 
 bool8 AnyNewQuests(void)
 {
     u16 i;
-    struct RogueQuestState* state;
+    u32 bits = 0;
 
-    for(i = 0; i < QUEST_CAPACITY; ++i)
-    {
-        state = &gRogueGlobalData.questStates[i];
-        if(state->isUnlocked && state->hasNewMarker)
-        {
-            return TRUE;
-        }
-    }
+    EnsureQuestMasks();
 
-    return FALSE;
+    for(i = 0; i < QUEST_MASK_WORDS; ++i)
+        bits |= sQuestMasks.unlocked[i] & sQuestMasks.newMarker[i];
+
+    return bits != 0;
 }
 
 bool8 AnyQuestRewardsPending(void)
 {
     u16 i;
-    struct RogueQuestState* state;
+    u32 bits = 0;
 
-    for(i = 0; i < QUEST_CAPACITY; ++i)
-    {
-        state = &gRogueGlobalData.questStates[i];
-        if(state->isUnlocked && state->hasPendingRewards)
-        {
-            return TRUE;
-        }
-    }
+    EnsureQuestMasks();
 
-    return FALSE;
+    for(i = 0; i < QUEST_MASK_WORDS; ++i)
+        bits |= sQuestMasks.unlocked[i] & sQuestMasks.pendingRewards[i];
+
+    return bits != 0;
 }
 
 bool8 AnyNewQuestsPending(void)
 {
     u16 i;
-    struct RogueQuestState* state;
+    u32 bits = 0;
 
-    for(i = 0; i < QUEST_CAPACITY; ++i)
-    {
-        state = &gRogueGlobalData.questStates[i];
-        if(state->isUnlocked && state->hasPendingRewards && DoesQuestHaveUnlocks(i))
-        {
-            return TRUE;
-        }
-    }
+    EnsureQuestMasks();
 
-    return FALSE;
+    for(i = 0; i < QUEST_MASK_WORDS; ++i)
+        bits |= sQuestMasks.unlocked[i] & sQuestMasks.pendingRewards[i] & sQuestMasks.hasUnlocks[i];
+
+    return bits != 0;
 }
 
 u16 GetCompletedQuestCount(void)
 {
     u16 i;
-    struct RogueQuestState* state;
     u16 count = 0;
 
-    for(i = 0; i < QUEST_CAPACITY; ++i)
-    {
-        state = &gRogueGlobalData.questStates[i];
-        if(state->isUnlocked && state->isCompleted)
-            ++count;
-    }
+    EnsureQuestMasks();
+
+    for(i = 0; i < QUEST_MASK_WORDS; ++i)
+        count += CountMaskBits(sQuestMasks.unlocked[i] & sQuestMasks.completed[i]);
 
     return count;
 }
@@ -204,15 +392,12 @@ u16 GetCompletedQuestCount(void)
 u16 GetUnlockedQuestCount(void)
 {
     u16 i;
-    struct RogueQuestState* state;
     u16 count = 0;
 
-    for(i = 0; i < QUEST_CAPACITY; ++i)
-    {
-        state = &gRogueGlobalData.questStates[i];
-        if(state->isUnlocked)
-            ++count;
-    }
+    EnsureQuestMasks();
+
+    for(i = 0; i < QUEST_MASK_WORDS; ++i)
+        count += CountMaskBits(sQuestMasks.unlocked[i]);
 
     return count;
 }
@@ -238,6 +423,7 @@ void SetQuestState(u16 questId, struct RogueQuestState* state)
     if(questId < QUEST_CAPACITY)
     {
         memcpy(&gRogueGlobalData.questStates[questId], state, sizeof(struct RogueQuestState));
+        SyncQuestMask(questId);
     }
 }
 
@@ -248,10 +434,12 @@ bool8 IsQuestRepeatable(u16 questId)
 
 bool8 IsQuestCollected(u16 questId)
 {
-    struct RogueQuestState state;
-    if (GetQuestState(questId, &state))
+    if(questId < QUEST_CAPACITY)
     {
-        return state.isCompleted && !state.hasPendingRewards;
+        u16 word = QUEST_MASK_WORD(questId);
+
+        EnsureQuestMasks();
+        return (sQuestMasks.unlocked[word] & sQuestMasks.completed[word] & ~sQuestMasks.pendingRewards[word] & QUEST_MASK_BIT(questId)) != 0;
     }
 
     return FALSE;
@@ -264,10 +452,10 @@ bool8 IsQuestGloballyTracked(u16 questId)
 
 bool8 IsQuestActive(u16 questId)
 {
-    struct RogueQuestState state;
-    if (GetQuestState(questId, &state))
+    if(questId < QUEST_CAPACITY)
     {
-        return state.isValid;
+        EnsureQuestMasks();
+        return (sQuestMasks.active[QUEST_MASK_WORD(questId)] & QUEST_MASK_BIT(questId)) != 0;
     }
 
     return FALSE;
@@ -324,6 +512,7 @@ static bool8 QueueNextReward()
         {
             // We've cleared out this quest's rewards
             gRogueGlobalData.questStates[sRewardQuest].hasPendingRewards = FALSE;
+            SyncQuestMask(sRewardQuest);
 
             sRewardQuest = QUEST_NONE;
             sRewardParam = 0;
@@ -472,6 +661,7 @@ bool8 TryUnlockQuest(u16 questId)
             }
         }
 
+        SyncQuestMask(questId);
         return TRUE;
     }
 
@@ -500,6 +690,7 @@ bool8 TryMarkQuestAsComplete(u16 questId)
             state->hasPendingRewards = TRUE;
         }
 
+        SyncQuestMask(questId);
         Rogue_PushPopup(POPUP_MSG_QUEST_COMPLETE, questId);
         return TRUE;
     }
@@ -514,6 +705,7 @@ bool8 TryDeactivateQuest(u16 questId)
     if(state->isValid)
     {
         state->isValid = FALSE;
+        SyncQuestMask(questId);
 
         if(state->isPinned)
             Rogue_PushPopup(POPUP_MSG_QUEST_FAIL, questId);
@@ -537,34 +729,44 @@ void UnlockFollowingQuests(u16 questId)
     }
 }
 
-static void ForEachUnlockedQuest(QuestCallback callback)
+// Calls back for every quest whose bit is set in the mask. Callbacks may
+// change the quest's state directly.
+static void ForEachQuestInMask(const u32* mask, bool8 skipCompleted, QuestCallback callback)
 {
     u16 i;
+    u16 word;
+    u32 bits;
     struct RogueQuestState* state;
 
-    for(i = QUEST_NONE + 1; i < QUEST_CAPACITY; ++i)
+    for(word = 0; word < QUEST_MASK_WORDS; ++word)
     {
-        state = &gRogueGlobalData.questStates[i];
-        if(state->isUnlocked)
+        bits = mask[word];
+
+        for(i = word * 32; bits != 0; ++i, bits >>= 1)
         {
-            callback(i, state);
+            if((bits & 1) && i != QUEST_NONE)
+            {
+                state = &gRogueGlobalData.questStates[i];
+                if(skipCompleted && state->isCompleted)
+                    continue;
+
+                callback(i, state);
+                SyncQuestMask(i);
+            }
         }
     }
 }
 
-static void ForEachActiveQuest(QuestCallback callback)
+static void ForEachUnlockedQuest(QuestCallback callback)
 {
-    u16 i;
-    struct RogueQuestState* state;
+    EnsureQuestMasks();
+    ForEachQuestInMask(sQuestMasks.unlocked, FALSE, callback);
+}
 
-    for(i = QUEST_NONE + 1; i < QUEST_CAPACITY; ++i)
-    {
-        state = &gRogueGlobalData.questStates[i];
-        if(state->isValid && !state->isCompleted)
-        {
-            callback(i, state);
-        }
-    }
+static void ForEachActiveQuest(QuestCallback callback)
+{
+    EnsureQuestMasks();
+    ForEachQuestInMask(sQuestMasks.active, TRUE, callback);
 }
 
 static void TryActivateQuestInternal(u16 questId, struct RogueQuestState* state)
@@ -879,6 +1081,9 @@ void QuestNotify_BeginAdventure(void)
 
 static void OnStartBattle(void)
 {
+    if(!IsQuestEventActive(QUEST_EVENT_PARTY_CHECK))
+        return;
+
     UpdateMonoQuests();
     
     if(IsQuestActive(QUEST_Hardcore3) || IsQuestActive(QUEST_Hardcore4) || IsQuestActive(QUEST_LegendOnly))
@@ -925,6 +1130,9 @@ static void OnEndBattle(void)
 {
     struct RogueQuestState state;
 
+    if(!IsQuestEventActive(QUEST_EVENT_BATTLE_END))
+        return;
+
     if(IsQuestActive(QUEST_Collector1))
     {
         u16 caughtCount = GetNationalPokedexCount(FLAG_GET_CAUGHT);
@@ -974,6 +1182,9 @@ static void UpdateMonoQuests(void)
     u16 questId;
     u8 i;
 
+    if(!IsQuestEventActive(QUEST_EVENT_PARTY_CHECK))
+        return;
+
     for(type = TYPE_NORMAL; type < NUMBER_OF_MON_TYPES; ++type)
     {
         questId = TypeToMonoQuest[type];
@@ -1112,6 +1323,9 @@ void QuestNotify_OnTrainerBattleEnd(bool8 isBossTrainer)
 
 void QuestNotify_OnMonFainted()
 {
+    if(!IsQuestEventActive(QUEST_EVENT_MON_FAINTED))
+        return;
+
     TryDeactivateQuest(QUEST_NoFainting2);
     TryDeactivateQuest(QUEST_NoFainting3);
 
@@ -1136,6 +1350,13 @@ void QuestNotify_OnExitHubTransition(void)
 
 void QuestNotify_OnWarp(struct WarpData* warp)
 {
+    if(Rogue_IsRunActive() && !IsQuestEventActive(QUEST_EVENT_WARP))
+    {
+        // Nothing to update, just track the room
+        sPreviousRouteType = gRogueAdvPath.currentRoomType;
+        return;
+    }
+
     if(Rogue_IsRunActive())
     {
         struct RogueQuestState state;
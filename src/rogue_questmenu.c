@@ -419,6 +419,11 @@ bool8 Rogue_IsQuestMenuOverviewActive(void)
     return sQuestMenuStruct->currentPage == MENU_PAGE_OVERVIEW;
 }
 
+bool8 Rogue_IsQuestMenuRewardsActive(void)
+{
+    return sQuestMenuMenuSate.showQuestRewards;
+}
+
 void Rogue_OpenQuestMenu(RogueQuestMenuCallback callback)
 {
     ScriptContext2_Enable();
@@ -1040,6 +1045,7 @@ static void HandleInput(bool8 showRewards)
             sQuestMenuMenuSate.showQuestRewards = FALSE;
         }
 
+        QuestMenuRefreshDetails(GetCurrentOptionMove());
         ScheduleBgCopyTilemapToVram(1);
         break;
     case LIST_CANCEL:
@@ -411,20 +411,21 @@ void RogueDebug_CompleteAvaliableQuests(void)
 #ifdef ROGUE_DEBUG
     u16 i;
     u16 questId;
-    struct RogueQuestState* state;
+    struct RogueQuestState state;
 
     for(i = 0; i < QUEST_CAPACITY; ++i)
     {
         // Work backwards to avoid completing new collected quests (Assuming unlocks always go forward in ID)
         questId = QUEST_CAPACITY - i - 1;
 
-        state = &gRogueGlobalData.questStates[questId];
-
-        if(state->isUnlocked && !state->isCompleted)
+        if(GetQuestState(questId, &state) && !state.isCompleted)
         {
-            state->isValid = FALSE;
-            state->isCompleted = TRUE;
-            state->hasPendingRewards = TRUE;
+            state.isValid = FALSE;
+            state.isCompleted = TRUE;
+            state.hasPendingRewards = TRUE;
+
+            // Goes through SetQuestState so the quest masks stay in sync
+            SetQuestState(questId, &state);
         }
     }
 #endif
@@ -436,7 +437,7 @@ void RogueDebug_CollectAllQuests(void)
     bool8 shouldLoop;
     u16 i;
     u16 questId;
-    struct RogueQuestState* state;
+    struct RogueQuestState state;
 
     shouldLoop = TRUE;
 
@@ -449,13 +450,12 @@ void RogueDebug_CollectAllQuests(void)
             // Work backwards to avoid completing new collected quests (Assuming unlocks always go forward in ID)
             questId = QUEST_CAPACITY - i - 1;
 
-            state = &gRogueGlobalData.questStates[questId];
-
-            if(state->isUnlocked && (!state->isCompleted || state->hasPendingRewards))
+            if(GetQuestState(questId, &state) && (!state.isCompleted || state.hasPendingRewards))
             {
-                state->isValid = FALSE;
-                state->isCompleted = TRUE;
-                state->hasPendingRewards = FALSE;
+                state.isValid = FALSE;
+                state.isCompleted = TRUE;
+                state.hasPendingRewards = FALSE;
+                SetQuestState(questId, &state);
 
                 UnlockFollowingQuests(questId);
                 shouldLoop = TRUE;
@@ -5,6 +5,7 @@
 #include "save.h"
 #include "task.h"
 #include "decompress.h"
+#include "item.h"
 #include "load_save.h"
 #include "overworld.h"
 #include "pokemon_storage_system.h"
@@ -14,9 +15,10 @@
 #include "constants/game_stat.h"
 
 static u16 CalculateChecksum(void *, u16);
+static u32 CalculateSectorHash(const void *, u16);
+static void SelectSaveSlotRotation(void);
 static bool8 ReadFlashSector(u8, struct SaveSector *);
-static u8 GetSaveValidStatus(const struct SaveSectorLocation *);
-static u8 CopySaveSlotData(u16, struct SaveSectorLocation *);
+static u8 GetSaveValidStatus(struct SaveSectorLocation *);
 static u8 TryWriteSector(u8, u8 *);
 static u8 HandleWriteSector(u16, const struct SaveSectorLocation *);
 static u8 HandleReplaceSector(u16, const struct SaveSectorLocation *);
@@ -39,6 +41,12 @@ static u8 HandleReplaceSector(u16, const struct SaveSectorLocation *);
  * might be done to reduce wear on the flash memory, but I'm not sure, since all
  * 14 sectors get written anyway.
  *
+ * Once a slot has been written since the game was loaded, the next save to it
+ * keeps the same rotation and skips any sector whose data hasn't changed (see
+ * sSaveSlotHashes). The SaveBlock2 sector is always written, and is written last,
+ * as its counter is the one used for the slot. This includes the incremental
+ * link save, where it is the sector whose security byte is written separately.
+ *
  * See SECTOR_ID_* constants in save.h
  */
 
@@ -93,9 +101,40 @@ struct SaveSectorLocation gRamSaveSectorLocations[NUM_SECTORS_PER_SLOT];
 u16 gSaveUnusedVar2;
 u16 gSaveAttemptStatus;
 
+#define BSS_CODE __attribute__((section(".bss.code")))
+
+extern char SumSaveWords[];
+extern char SumSaveWords_End[];
+
+// ARM checksum loop from save_checksum.s, copied here by InitSaveChecksumCode
+BSS_CODE ALIGNED(4) static char sSumSaveWordsBuffer[0x60] = {0};
+
 EWRAM_DATA struct SaveSector gSaveDataBuffer = {0}; // Buffer used for reading/writing sectors
 EWRAM_DATA static u8 sUnusedVar = 0;
 
+// Hashes of the data last written to each sector of each save slot.
+// Only sectors written in full since the game was loaded are tracked, and
+// any damaged sector forgets everything.
+struct SaveSlotHashes
+{
+    u32 hashes[NUM_SECTORS_PER_SLOT];
+    u16 validSectors;
+    u16 rotation; // gLastWrittenSector when the hashes were recorded
+};
+
+EWRAM_DATA static struct SaveSlotHashes sSaveSlotHashes[NUM_SAVE_SLOTS] = {0};
+
+static void ClearSaveSlotHashes(void)
+{
+    memset(sSaveSlotHashes, 0, sizeof(sSaveSlotHashes));
+}
+
+void InitSaveChecksumCode(void)
+{
+    AGB_ASSERT(SumSaveWords_End - SumSaveWords <= sizeof(sSumSaveWordsBuffer));
+    CpuCopy32(SumSaveWords, sSumSaveWordsBuffer, sizeof(sSumSaveWordsBuffer));
+}
+
 void ClearSaveData(void)
 {
     u16 i;
@@ -106,6 +145,8 @@ void ClearSaveData(void)
         EraseFlashSector(i);
         EraseFlashSector(i + SECTORS_COUNT / 2);
     }
+
+    ClearSaveSlotHashes();
 }
 
 void Save_ResetSaveCounters(void)
@@ -113,6 +154,7 @@ void Save_ResetSaveCounters(void)
     gSaveCounter = 0;
     gLastWrittenSector = 0;
     gDamagedSaveSectors = 0;
+    ClearSaveSlotHashes();
 }
 
 static bool32 SetDamagedSectorBits(u8 op, u8 sectorId)
@@ -123,6 +165,7 @@ static bool32 SetDamagedSectorBits(u8 op, u8 sectorId)
     {
     case ENABLE:
         gDamagedSaveSectors |= (1 << sectorId);
+        ClearSaveSlotHashes();
         break;
     case DISABLE:
         gDamagedSaveSectors &= ~(1 << sectorId);
@@ -154,13 +197,14 @@ static u8 WriteSaveSectorOrSlot(u16 sectorId, const struct SaveSectorLocation *l
         // No sector was specified, write full save slot.
         gLastKnownGoodSector = gLastWrittenSector; // backup the current written sector before attempting to write.
         gLastSaveCounter = gSaveCounter;
-        gLastWrittenSector++;
-        gLastWrittenSector = gLastWrittenSector % NUM_SECTORS_PER_SLOT;
         gSaveCounter++;
+        SelectSaveSlotRotation();
         status = SAVE_STATUS_OK;
 
-        for (i = 0; i < NUM_SECTORS_PER_SLOT; i++)
+        // SaveBlock2 last, so the slot's counter is only updated once everything else is written
+        for (i = SECTOR_ID_SAVEBLOCK2 + 1; i < NUM_SECTORS_PER_SLOT; i++)
             HandleWriteSector(i, locations);
+        HandleWriteSector(SECTOR_ID_SAVEBLOCK2, locations);
 
         if (gDamagedSaveSectors)
         {
@@ -174,12 +218,31 @@ static u8 WriteSaveSectorOrSlot(u16 sectorId, const struct SaveSectorLocation *l
     return status;
 }
 
+// Called once gSaveCounter points at the slot about to be written
+static void SelectSaveSlotRotation(void)
+{
+    struct SaveSlotHashes *slot = &sSaveSlotHashes[gSaveCounter % NUM_SAVE_SLOTS];
+
+    if (slot->validSectors != 0)
+    {
+        // Keep every sector where it is, so unchanged ones don't need writing
+        gLastWrittenSector = slot->rotation;
+    }
+    else
+    {
+        gLastWrittenSector++;
+        gLastWrittenSector %= NUM_SECTORS_PER_SLOT;
+    }
+}
+
 static u8 HandleWriteSector(u16 sectorId, const struct SaveSectorLocation *locations)
 {
-    u16 i;
     u16 sector;
     u8 *data;
     u16 size;
+    u32 hash;
+    u8 status;
+    struct SaveSlotHashes *slot = &sSaveSlotHashes[gSaveCounter % NUM_SAVE_SLOTS];
 
     // Adjust sector id for current save slot
     sector = sectorId + gLastWrittenSector;
@@ -190,9 +253,21 @@ static u8 HandleWriteSector(u16 sectorId, const struct SaveSectorLocation *locat
     data = locations[sectorId].data;
     size = locations[sectorId].size;
 
+    if (slot->rotation != gLastWrittenSector)
+    {
+        slot->validSectors = 0;
+        slot->rotation = gLastWrittenSector;
+    }
+
+    // Skip the sector if the slot already has this data in it
+    hash = CalculateSectorHash(data, size);
+    if (sectorId != SECTOR_ID_SAVEBLOCK2
+     && (slot->validSectors & (1 << sectorId))
+     && slot->hashes[sectorId] == hash)
+        return SAVE_STATUS_OK;
+
     // Clear temp save sector
-    for (i = 0; i < SECTOR_SIZE; i++)
-        ((u8 *)gReadWriteSector)[i] = 0;
+    CpuFill32(0, gReadWriteSector, SECTOR_SIZE);
 
     // Set footer data
     gReadWriteSector->id = sectorId;
@@ -200,28 +275,31 @@ static u8 HandleWriteSector(u16 sectorId, const struct SaveSectorLocation *locat
     gReadWriteSector->counter = gSaveCounter;
 
     // Copy current data to temp buffer for writing
-    for (i = 0; i < size; i++)
-        gReadWriteSector->data[i] = data[i];
+    CpuCopy32(data, gReadWriteSector->data, size);
 
     gReadWriteSector->checksum = CalculateChecksum(data, size);
 
-    return TryWriteSector(sector, gReadWriteSector->data);
+    status = TryWriteSector(sector, gReadWriteSector->data);
+    if (status == SAVE_STATUS_OK)
+    {
+        slot->hashes[sectorId] = hash;
+        slot->validSectors |= (1 << sectorId);
+    }
+
+    return status;
 }
 
 static u8 HandleWriteSectorNBytes(u8 sectorId, u8 *data, u16 size)
 {
-    u16 i;
     struct SaveSector *sector = &gSaveDataBuffer;
 
     // Clear temp save sector
-    for (i = 0; i < SECTOR_SIZE; i++)
-        ((u8 *)sector)[i] = 0;
+    CpuFill32(0, sector, SECTOR_SIZE);
 
     sector->security = SECTOR_SECURITY_NUM;
 
     // Copy data to temp buffer for writing
-    for (i = 0; i < size; i++)
-        sector->data[i] = data[i];
+    CpuCopy32(data, sector->data, size);
 
     sector->id = CalculateChecksum(data, size); // though this appears to be incorrect, it might be some sector checksum instead of a whole save checksum and only appears to be relevent to HOF data, if used.
     return TryWriteSector(sectorId, sector->data);
@@ -248,9 +326,8 @@ static u32 RestoreSaveBackupVarsAndIncrement(const struct SaveSectorLocation *lo
     gReadWriteSector = &gSaveDataBuffer;
     gLastKnownGoodSector = gLastWrittenSector;
     gLastSaveCounter = gSaveCounter;
-    gLastWrittenSector++;
-    gLastWrittenSector %= NUM_SECTORS_PER_SLOT;
     gSaveCounter++;
+    SelectSaveSlotRotation();
     gIncrementalSectorId = 0;
     gDamagedSaveSectors = 0;
     return 0;
@@ -272,8 +349,10 @@ static u8 HandleWriteIncrementalSector(u16 numSectors, const struct SaveSectorLo
 
     if (gIncrementalSectorId < numSectors - 1)
     {
+        // Every sector but SaveBlock2, which LinkFullSave_ReplaceLastSector writes
+        // once these are done, as its counter is the one used for the slot
         status = SAVE_STATUS_OK;
-        HandleWriteSector(gIncrementalSectorId, locations);
+        HandleWriteSector(SECTOR_ID_SAVEBLOCK2 + 1 + gIncrementalSectorId, locations);
         gIncrementalSectorId++;
         if (gDamagedSaveSectors)
         {
@@ -324,9 +403,12 @@ static u8 HandleReplaceSector(u16 sectorId, const struct SaveSectorLocation *loc
     data = locations[sectorId].data;
     size = locations[sectorId].size;
 
+    // The security byte is written separately, so this sector can't be
+    // assumed complete until it's next written in full
+    sSaveSlotHashes[gSaveCounter % NUM_SAVE_SLOTS].validSectors &= ~(1 << sectorId);
+
     // Clear temp save sector.
-    for (i = 0; i < SECTOR_SIZE; i++)
-        ((u8 *)gReadWriteSector)[i] = 0;
+    CpuFill32(0, gReadWriteSector, SECTOR_SIZE);
 
     // Set footer data
     gReadWriteSector->id = sectorId;
@@ -334,8 +416,7 @@ static u8 HandleReplaceSector(u16 sectorId, const struct SaveSectorLocation *loc
     gReadWriteSector->counter = gSaveCounter;
 
     // Copy current data to temp buffer for writing
-    for (i = 0; i < size; i++)
-        gReadWriteSector->data[i] = data[i];
+    CpuCopy32(data, gReadWriteSector->data, size);
 
     gReadWriteSector->checksum = CalculateChecksum(data, size);
 
@@ -475,160 +556,133 @@ static u8 TryLoadSaveSlot(u16 sectorId, struct SaveSectorLocation *locations)
     }
     else
     {
+        ClearSaveSlotHashes();
         status = GetSaveValidStatus(locations);
-        CopySaveSlotData(FULL_SAVE_SLOT, locations);
     }
 
     return status;
 }
 
-// sectorId arg is ignored, this always reads the full save slot
-static u8 CopySaveSlotData(u16 sectorId, struct SaveSectorLocation *locations)
+// Reads only the sector footers, which is enough to tell whether a slot is
+// empty, is missing sectors, or can be loaded. Checksums are left to
+// LoadSaveSlotSectors, so only the slot that actually gets loaded is read in full.
+static u8 ReadSaveSlotFooters(u8 slot, u32 *counter)
 {
     u16 i;
-    u16 checksum;
-    u16 slotOffset = NUM_SECTORS_PER_SLOT * (gSaveCounter % NUM_SAVE_SLOTS);
-    u16 id;
+    u32 sectorIdFlags = 0;
+    bool8 securityPassed = FALSE;
+    struct SaveSector *sector = gReadWriteSector;
 
     for (i = 0; i < NUM_SECTORS_PER_SLOT; i++)
     {
-        ReadFlashSector(i + slotOffset, gReadWriteSector);
-
-        id = gReadWriteSector->id;
-        if (id == 0)
-            gLastWrittenSector = i;
-
-        checksum = CalculateChecksum(gReadWriteSector->data, locations[id].size);
-
-        // Only copy data for sectors whose security and checksum fields are correct
-        if (gReadWriteSector->security == SECTOR_SECURITY_NUM && gReadWriteSector->checksum == checksum)
+        ReadFlash(i + NUM_SECTORS_PER_SLOT * slot, SECTOR_FOOTER_ID_OFFSET, (u8 *)&sector->id, SECTOR_SIZE - SECTOR_FOOTER_ID_OFFSET);
+        if (sector->security == SECTOR_SECURITY_NUM && sector->id < NUM_SECTORS_PER_SLOT)
         {
-            u16 j;
-            for (j = 0; j < locations[id].size; j++)
-                ((u8 *)locations[id].data)[j] = gReadWriteSector->data[j];
+            securityPassed = TRUE;
+            sectorIdFlags |= 1 << sector->id;
+
+            // Other sectors may be left over from earlier saves, if they didn't change
+            if (sector->id == SECTOR_ID_SAVEBLOCK2)
+                *counter = sector->counter;
         }
     }
 
-    return SAVE_STATUS_OK;
+    if (!securityPassed)
+        return SAVE_STATUS_EMPTY; // No sectors have the security number, treat the slot as empty
+    else if (sectorIdFlags == (1 << NUM_SECTORS_PER_SLOT) - 1)
+        return SAVE_STATUS_OK;
+    else
+        return SAVE_STATUS_ERROR;
 }
 
-static u8 GetSaveValidStatus(const struct SaveSectorLocation *locations)
+// Copies the data of every sector in the slot whose security and checksum fields
+// are correct. Returns SAVE_STATUS_OK if that was all of them.
+static u8 LoadSaveSlotSectors(u8 slot, struct SaveSectorLocation *locations)
 {
     u16 i;
+    u16 id;
     u16 checksum;
-    u32 saveSlot1Counter = 0;
-    u32 saveSlot2Counter = 0;
     u32 validSectorFlags = 0;
-    bool8 securityPassed = FALSE;
-    u8 saveSlot1Status;
-    u8 saveSlot2Status;
 
-    // Check save slot 1
     for (i = 0; i < NUM_SECTORS_PER_SLOT; i++)
     {
-        ReadFlashSector(i, gReadWriteSector);
-        if (gReadWriteSector->security == SECTOR_SECURITY_NUM)
+        ReadFlashSector(i + NUM_SECTORS_PER_SLOT * slot, gReadWriteSector);
+
+        id = gReadWriteSector->id;
+        if (gReadWriteSector->security != SECTOR_SECURITY_NUM || id >= NUM_SECTORS_PER_SLOT)
+            continue;
+
+        if (id == SECTOR_ID_SAVEBLOCK2)
+            gLastWrittenSector = i;
+
+        checksum = CalculateChecksum(gReadWriteSector->data, locations[id].size);
+        if (gReadWriteSector->checksum == checksum)
         {
-            securityPassed = TRUE;
-            checksum = CalculateChecksum(gReadWriteSector->data, locations[gReadWriteSector->id].size);
-            if (gReadWriteSector->checksum == checksum)
-            {
-                saveSlot1Counter = gReadWriteSector->counter;
-                validSectorFlags |= 1 << gReadWriteSector->id;
-            }
+            CpuCopy32(gReadWriteSector->data, locations[id].data, locations[id].size);
+            validSectorFlags |= 1 << id;
         }
     }
 
-    if (securityPassed)
-    {
-        if (validSectorFlags == (1 << NUM_SECTORS_PER_SLOT) - 1)
-            saveSlot1Status = SAVE_STATUS_OK;
-        else
-            saveSlot1Status = SAVE_STATUS_ERROR;
-    }
+    if (validSectorFlags == (1 << NUM_SECTORS_PER_SLOT) - 1)
+        return SAVE_STATUS_OK;
     else
-    {
-        // No sectors in slot 1 have the security number, treat it as empty
-        saveSlot1Status = SAVE_STATUS_EMPTY;
-    }
+        return SAVE_STATUS_ERROR;
+}
 
-    validSectorFlags = 0;
-    securityPassed = FALSE;
+// Picks the newest complete save slot from the sector footers and loads it,
+// falling back to the other slot if any of its checksums are wrong.
+//
+// Unlike the original, the older slot's checksums aren't checked when the newest
+// slot loads, so bad data in it alone no longer gives SAVE_STATUS_ERROR. That
+// status tells the player the previous save is being loaded, and resets the win
+// streaks on continue, neither of which applies when the newest save is intact.
+static u8 GetSaveValidStatus(struct SaveSectorLocation *locations)
+{
+    u8 slot;
+    u8 slotStatus[NUM_SAVE_SLOTS];
+    u32 slotCounter[NUM_SAVE_SLOTS] = {0};
 
-    // Check save slot 2
-    for (i = 0; i < NUM_SECTORS_PER_SLOT; i++)
+    slotStatus[0] = ReadSaveSlotFooters(0, &slotCounter[0]);
+    slotStatus[1] = ReadSaveSlotFooters(1, &slotCounter[1]);
+
+    if (slotStatus[0] == SAVE_STATUS_EMPTY && slotStatus[1] == SAVE_STATUS_EMPTY)
     {
-        ReadFlashSector(i + NUM_SECTORS_PER_SLOT, gReadWriteSector);
-        if (gReadWriteSector->security == SECTOR_SECURITY_NUM)
-        {
-            securityPassed = TRUE;
-            checksum = CalculateChecksum(gReadWriteSector->data, locations[gReadWriteSector->id].size);
-            if (gReadWriteSector->checksum == checksum)
-            {
-                saveSlot2Counter = gReadWriteSector->counter;
-                validSectorFlags |= 1 << gReadWriteSector->id;
-            }
-        }
+        gSaveCounter = 0;
+        gLastWrittenSector = 0;
+        return SAVE_STATUS_EMPTY;
     }
 
-    if (securityPassed)
+    // Try the newest slot first
+    if (slotStatus[0] == SAVE_STATUS_OK && slotStatus[1] == SAVE_STATUS_OK)
     {
-        if (validSectorFlags == (1 << NUM_SECTORS_PER_SLOT) - 1)
-            saveSlot2Status = SAVE_STATUS_OK;
+        if ((slotCounter[0] == -1 && slotCounter[1] ==  0)
+         || (slotCounter[0] ==  0 && slotCounter[1] == -1))
+            slot = ((unsigned)(slotCounter[0] + 1) < (unsigned)(slotCounter[1] + 1)) ? 1 : 0;
         else
-            saveSlot2Status = SAVE_STATUS_ERROR;
+            slot = (slotCounter[0] < slotCounter[1]) ? 1 : 0;
     }
     else
     {
-        // No sectors in slot 2 have the security number, treat it as empty.
-        saveSlot2Status = SAVE_STATUS_EMPTY;
-    }
-
-    if (saveSlot1Status == SAVE_STATUS_OK && saveSlot2Status == SAVE_STATUS_OK)
-    {
-        if ((saveSlot1Counter == -1 && saveSlot2Counter ==  0)
-         || (saveSlot1Counter ==  0 && saveSlot2Counter == -1))
-        {
-            if ((unsigned)(saveSlot1Counter + 1) < (unsigned)(saveSlot2Counter + 1))
-                gSaveCounter = saveSlot2Counter;
-            else
-                gSaveCounter = saveSlot1Counter;
-        }
-        else
-        {
-            if (saveSlot1Counter < saveSlot2Counter)
-                gSaveCounter = saveSlot2Counter;
-            else
-                gSaveCounter = saveSlot1Counter;
-        }
-        return SAVE_STATUS_OK;
+        slot = (slotStatus[1] == SAVE_STATUS_OK) ? 1 : 0;
     }
 
-    // One or both save slots are not OK
-
-    if (saveSlot1Status == SAVE_STATUS_OK)
+    if (slotStatus[slot] == SAVE_STATUS_OK && LoadSaveSlotSectors(slot, locations) == SAVE_STATUS_OK)
     {
-        gSaveCounter = saveSlot1Counter;
-        if (saveSlot2Status == SAVE_STATUS_ERROR)
-            return SAVE_STATUS_ERROR; // Slot 2 errored
-        return SAVE_STATUS_OK; // Slot 1 is OK, slot 2 is empty
-    }
+        gSaveCounter = slotCounter[slot];
 
-    if (saveSlot2Status == SAVE_STATUS_OK)
-    {
-        gSaveCounter = saveSlot2Counter;
-        if (saveSlot1Status == SAVE_STATUS_ERROR)
-            return SAVE_STATUS_ERROR; // Slot 1 errored
-        return SAVE_STATUS_OK; // Slot 2 is OK, slot 1 is empty
+        // Still report the other slot if its footers show sectors missing, as
+        // that costs nothing extra to find
+        if (slotStatus[slot ^ 1] == SAVE_STATUS_ERROR)
+            return SAVE_STATUS_ERROR;
+        return SAVE_STATUS_OK;
     }
 
-    // Neither slot is OK, check if both are empty
-    if (saveSlot1Status == SAVE_STATUS_EMPTY
-     && saveSlot2Status == SAVE_STATUS_EMPTY)
+    // Fall back to the previous save
+    slot ^= 1;
+    if (slotStatus[slot] == SAVE_STATUS_OK && LoadSaveSlotSectors(slot, locations) == SAVE_STATUS_OK)
     {
-        gSaveCounter = 0;
-        gLastWrittenSector = 0;
-        return SAVE_STATUS_EMPTY;
+        gSaveCounter = slotCounter[slot];
+        return SAVE_STATUS_ERROR;
     }
 
     // Both slots errored
@@ -639,7 +693,6 @@ static u8 GetSaveValidStatus(const struct SaveSectorLocation *locations)
 
 static u8 TryLoadSaveSector(u8 sectorId, u8 *data, u16 size)
 {
-    u16 i;
     struct SaveSector *sector = &gSaveDataBuffer;
     ReadFlashSector(sectorId, sector);
     if (sector->security == SECTOR_SECURITY_NUM)
@@ -648,8 +701,7 @@ static u8 TryLoadSaveSector(u8 sectorId, u8 *data, u16 size)
         if (sector->id == checksum)
         {
             // Security and checksum are correct, copy data
-            for (i = 0; i < size; i++)
-                data[i] = sector->data[i];
+            CpuCopy32(sector->data, data, size);
             return SAVE_STATUS_OK;
         }
         else
@@ -673,17 +725,39 @@ static bool8 ReadFlashSector(u8 sectorId, struct SaveSector *sector)
 }
 
 static u16 CalculateChecksum(void *data, u16 size)
+{
+    u32 checksum = ((u32 (*)(const void *, u32))sSumSaveWordsBuffer)(data, size / 4);
+
+    return ((checksum >> 16) + checksum);
+}
+
+// Unlike the checksum this has to notice any change to the data, as a
+// sector is skipped when saving if its hash matches (MurmurHash3).
+static u32 CalculateSectorHash(const void *data, u16 size)
 {
     u16 i;
-    u32 checksum = 0;
+    const u32 *words = data;
+    u32 hash = 0;
+    u32 k;
 
     for (i = 0; i < (size / 4); i++)
     {
-        checksum += *((u32 *)data);
-        data += sizeof(u32);
+        k = words[i] * 0xCC9E2D51;
+        k = (k << 15) | (k >> 17);
+        k *= 0x1B873593;
+
+        hash ^= k;
+        hash = (hash << 13) | (hash >> 19);
+        hash = hash * 5 + 0xE6546B64;
     }
 
-    return ((checksum >> 16) + checksum);
+    hash ^= size;
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6B;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35;
+    hash ^= hash >> 16;
+    return hash;
 }
 
 static void UpdateSaveAddresses(void)
@@ -812,9 +886,11 @@ bool8 LinkFullSave_WriteSector(void)
         return FALSE;
 }
 
+// Writes SaveBlock2 apart from the first byte of its security field, which
+// LinkFullSave_SetLastSectorSecurity writes to finish the save
 bool8 LinkFullSave_ReplaceLastSector(void)
 {
-    HandleReplaceSectorAndVerify(NUM_SECTORS_PER_SLOT, gRamSaveSectorLocations);
+    HandleReplaceSectorAndVerify(SECTOR_ID_SAVEBLOCK2 + 1, gRamSaveSectorLocations);
     if (gDamagedSaveSectors)
         DoSaveFailedScreen(SAVE_NORMAL);
     return FALSE;
@@ -822,7 +898,7 @@ bool8 LinkFullSave_ReplaceLastSector(void)
 
 bool8 LinkFullSave_SetLastSectorSecurity(void)
 {
-    CopySectorSecurityByte(NUM_SECTORS_PER_SLOT, gRamSaveSectorLocations);
+    CopySectorSecurityByte(SECTOR_ID_SAVEBLOCK2 + 1, gRamSaveSectorLocations);
     if (gDamagedSaveSectors)
         DoSaveFailedScreen(SAVE_NORMAL);
     return FALSE;
@@ -888,6 +964,8 @@ u8 LoadGameSave(u8 saveType)
     default:
         status = TryLoadSaveSlot(FULL_SAVE_SLOT, gRamSaveSectorLocations);
         CopyPartyAndObjectsFromSave();
+        InvalidateBagItemIndex();
+        InvalidateStorageIndex();
         gSaveFileStatus = status;
         gGameContinueCallback = 0;
         break;
@@ -0,0 +1,48 @@
+	.include "asm/macros.inc"
+
+	.syntax unified
+
+	.text
+
+@ u32 SumSaveWords(const u32 *data, u32 numWords)
+@
+@ Returns the 32-bit sum of numWords words, which CalculateChecksum folds into
+@ a sector checksum. Eight words are loaded per ldmia, then any remainder one
+@ at a time. data must be word aligned.
+@
+@ This runs from IWRAM. InitSaveChecksumCode copies it to
+@ sSumSaveWordsBuffer, which is sized to hold everything up to
+@ SumSaveWords_End.
+	arm_func_start SumSaveWords
+SumSaveWords:
+	push {r4-r10}
+	mov r2, 0                       @ r2 = sum
+	subs r1, r1, 8
+	blo SumSaveWords_Tail
+SumSaveWords_Loop:
+	ldmia r0!, {r3-r10}
+	add r2, r2, r3
+	add r2, r2, r4
+	add r2, r2, r5
+	add r2, r2, r6
+	add r2, r2, r7
+	add r2, r2, r8
+	add r2, r2, r9
+	add r2, r2, r10
+	subs r1, r1, 8
+	bhs SumSaveWords_Loop
+SumSaveWords_Tail:
+	adds r1, r1, 8                  @ r1 = words left over, 0-7
+	beq SumSaveWords_Done
+SumSaveWords_TailLoop:
+	ldr r3, [r0], 4
+	add r2, r2, r3
+	subs r1, r1, 1
+	bne SumSaveWords_TailLoop
+SumSaveWords_Done:
+	mov r0, r2
+	pop {r4-r10}
+	bx lr
+	.global SumSaveWords_End
+SumSaveWords_End:
+	arm_func_end SumSaveWords
@@ -6,6 +6,8 @@
 #include "constants/event_objects.h"
 #include "constants/map_scripts.h"
 
+#include "rogue_profiler.h"
+
 //#include "rogue_controller.h"
 
 #define RAM_SCRIPT_MAGIC 51
@@ -214,13 +216,17 @@ bool8 ScriptContext2_RunScript(void)
 
     ScriptContext2_Enable();
 
+    PROFILE_BEGIN(PROFILE_SECTION_SCRIPT);
+
     if (!RunScriptCommand(&sScriptContext1))
     {
+        PROFILE_END(PROFILE_SECTION_SCRIPT);
         sScriptContext1Status = 2;
         ScriptContext2_Disable();
         return FALSE;
     }
 
+    PROFILE_END(PROFILE_SECTION_SCRIPT);
     return TRUE;
 }
 
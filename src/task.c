@@ -1,10 +1,18 @@
 #include "global.h"
 #include "task.h"
 
+#include "rogue_profiler.h"
+
 struct Task gTasks[NUM_TASKS];
 
+// First task in the run list. Only meaningful while a task is active.
+static u8 sTaskListHead;
+
+// Bit n is set while gTasks[n] is active. The clear bits double as the free
+// list, so new tasks still take the lowest free id.
+static u16 sActiveTaskBits;
+
 static void InsertTask(u8 newTaskId);
-static u8 FindFirstActiveTask(void);
 
 void ResetTasks(void)
 {
@@ -22,37 +30,41 @@ void ResetTasks(void)
 
     gTasks[0].prev = HEAD_SENTINEL;
     gTasks[NUM_TASKS - 1].next = TAIL_SENTINEL;
+
+    sTaskListHead = TAIL_SENTINEL;
+    sActiveTaskBits = 0;
 }
 
 u8 CreateTask(TaskFunc func, u8 priority)
 {
     u8 i;
+    u16 freeBits = ~sActiveTaskBits;
 
-    for (i = 0; i < NUM_TASKS; i++)
-    {
-        if (!gTasks[i].isActive)
-        {
-            gTasks[i].func = func;
-            gTasks[i].priority = priority;
-            InsertTask(i);
-            memset(gTasks[i].data, 0, sizeof(gTasks[i].data));
-            gTasks[i].isActive = TRUE;
-            return i;
-        }
-    }
+    if (sActiveTaskBits == (1 << NUM_TASKS) - 1)
+        return 0;
 
-    return 0;
+    for (i = 0; !(freeBits & 1); i++)
+        freeBits >>= 1;
+
+    gTasks[i].func = func;
+    gTasks[i].priority = priority;
+    InsertTask(i);
+    memset(gTasks[i].data, 0, sizeof(gTasks[i].data));
+    gTasks[i].isActive = TRUE;
+    sActiveTaskBits |= 1 << i;
+    return i;
 }
 
 static void InsertTask(u8 newTaskId)
 {
-    u8 taskId = FindFirstActiveTask();
+    u8 taskId = sTaskListHead;
 
-    if (taskId == NUM_TASKS)
+    if (sActiveTaskBits == 0)
     {
         // The new task is the only task.
         gTasks[newTaskId].prev = HEAD_SENTINEL;
         gTasks[newTaskId].next = TAIL_SENTINEL;
+        sTaskListHead = newTaskId;
         return;
     }
 
@@ -66,6 +78,8 @@ static void InsertTask(u8 newTaskId)
             gTasks[newTaskId].next = taskId;
             if (gTasks[taskId].prev != HEAD_SENTINEL)
                 gTasks[gTasks[taskId].prev].next = newTaskId;
+            else
+                sTaskListHead = newTaskId;
             gTasks[taskId].prev = newTaskId;
             return;
         }
@@ -86,9 +100,11 @@ void DestroyTask(u8 taskId)
     if (gTasks[taskId].isActive)
     {
         gTasks[taskId].isActive = FALSE;
+        sActiveTaskBits &= ~(1 << taskId);
 
         if (gTasks[taskId].prev == HEAD_SENTINEL)
         {
+            sTaskListHead = gTasks[taskId].next;
             if (gTasks[taskId].next != TAIL_SENTINEL)
                 gTasks[gTasks[taskId].next].prev = HEAD_SENTINEL;
         }
@@ -109,9 +125,11 @@ void DestroyTask(u8 taskId)
 
 void RunTasks(void)
 {
-    u8 taskId = FindFirstActiveTask();
+    u8 taskId = sTaskListHead;
+
+    PROFILE_BEGIN(PROFILE_SECTION_TASKS);
 
-    if (taskId != NUM_TASKS)
+    if (sActiveTaskBits != 0)
     {
         do
         {
@@ -119,17 +137,8 @@ void RunTasks(void)
             taskId = gTasks[taskId].next;
         } while (taskId != TAIL_SENTINEL);
     }
-}
-
-static u8 FindFirstActiveTask(void)
-{
-    u8 taskId;
-
-    for (taskId = 0; taskId < NUM_TASKS; taskId++)
-        if (gTasks[taskId].isActive == TRUE && gTasks[taskId].prev == HEAD_SENTINEL)
-            break;
 
-    return taskId;
+    PROFILE_END(PROFILE_SECTION_TASKS);
 }
 
 void TaskDummy(u8 taskId)
@@ -154,34 +163,30 @@ void SwitchTaskToFollowupFunc(u8 taskId)
 
 bool8 FuncIsActiveTask(TaskFunc func)
 {
-    u8 i;
-
-    for (i = 0; i < NUM_TASKS; i++)
-        if (gTasks[i].isActive == TRUE && gTasks[i].func == func)
-            return TRUE;
-
-    return FALSE;
+    return FindTaskIdByFunc(func) != TASK_NONE;
 }
 
+// Only visits active tasks, lowest id first. Task funcs are reassigned
+// directly all over the codebase, so there is no func to id map to keep.
 u8 FindTaskIdByFunc(TaskFunc func)
 {
-    s32 i;
+    u8 i;
+    u16 activeBits;
 
-    for (i = 0; i < NUM_TASKS; i++)
-        if (gTasks[i].isActive == TRUE && gTasks[i].func == func)
-            return (u8)i;
+    for (i = 0, activeBits = sActiveTaskBits; activeBits != 0; i++, activeBits >>= 1)
+        if ((activeBits & 1) && gTasks[i].func == func)
+            return i;
 
     return TASK_NONE; // No task was found.
 }
 
 u8 GetTaskCount(void)
 {
-    u8 i;
     u8 count = 0;
+    u16 activeBits;
 
-    for (i = 0; i < NUM_TASKS; i++)
-        if (gTasks[i].isActive == TRUE)
-            count++;
+    for (activeBits = sActiveTaskBits; activeBits != 0; activeBits &= activeBits - 1)
+        count++;
 
     return count;
 }
@@ -263,8 +263,17 @@ u32 CalcByteArraySum(const u8* data, u32 length)
 
 void BlendPalette(u16 palOffset, u16 numEntries, u8 coeff, u16 blendColor)
 {
-    u16 i;
-    for (i = 0; i < numEntries; i++)
+    u16 i = 0;
+
+    // Word aligned runs go through the IWRAM blend loop two colors at a time.
+    // It only handles the coefficients fades actually use.
+    if (coeff <= 16 && !(palOffset & 1))
+    {
+        BlendPaletteWordsRam((const u32 *)&gPlttBufferUnfaded[palOffset], (u32 *)&gPlttBufferFaded[palOffset], numEntries / 2, coeff, blendColor);
+        i = numEntries & ~1;
+    }
+
+    for (; i < numEntries; i++)
     {
         u16 index = i + palOffset;
         struct PlttData *data1 = (struct PlttData *)&gPlttBufferUnfaded[index];
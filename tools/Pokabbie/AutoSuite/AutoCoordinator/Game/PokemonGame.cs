@@ -15,6 +15,8 @@ namespace AutoCoordinator.Game
 
 		private uint m_AutoBufferSize;
 		private uint m_AutoBufferAddr;
+		private uint m_SnapshotSize;
+		private uint m_SnapshotAddr;
 		private ushort m_CommandCounter;
 
 		private BufferedStringTable<uint> m_SpeciesNameTable;
@@ -58,6 +60,16 @@ namespace AutoCoordinator.Game
 			WarpNextAdventureEncounter,
 			SetAutomationFlag,
 			GetAutomationFlag,
+			SaveSnapshot,
+			LoadSnapshot,
+			ApplySaveMigrations,
+		}
+
+		public struct SaveMigrationResult
+		{
+			public int FirstStep;
+			public int ChangedSteps; // One bit per step
+			public int MigrationLevel;
 		}
 
 		public enum AutomationFlag
@@ -87,6 +99,8 @@ namespace AutoCoordinator.Game
 			{
 				m_AutoBufferSize = m_Connection.Cmd_Emu_Read32(m_Header.AutomationHeaderAddr + 0);
 				m_AutoBufferAddr = m_Connection.Cmd_Emu_Read32(m_Header.AutomationHeaderAddr + 4);
+				m_SnapshotSize = m_Connection.Cmd_Emu_Read32(m_Header.AutomationHeaderAddr + 8);
+				m_SnapshotAddr = m_Connection.Cmd_Emu_Read32(m_Header.AutomationHeaderAddr + 12);
 				return true;
 			}
 
@@ -355,5 +369,58 @@ namespace AutoCoordinator.Game
 
 			return false;
 		}
+
+		/// <summary>
+		/// Runs the save migration table over the loaded save as if it had these version fields.
+		/// The migrations change the save, so this should only be used on a scratch save.
+		/// </summary>
+		public SaveMigrationResult ApplySaveMigrations(int saveVersion, int compatVersion, int migrationLevel)
+		{
+			SaveMigrationResult result = new SaveMigrationResult();
+			result.FirstStep = -1;
+
+			if (PushCmd(CommandCode.ApplySaveMigrations, saveVersion, compatVersion, migrationLevel))
+			{
+				result.FirstStep = ReadReturnValue(0);
+				result.ChangedSteps = ReadReturnValue(1);
+				result.MigrationLevel = ReadReturnValue(2);
+			}
+
+			return result;
+		}
+
+		public RogueSnapshot SaveSnapshot()
+		{
+			if (!PushCmd(CommandCode.SaveSnapshot))
+				return null;
+
+			// The snapshot is always word sized, as it's made up of word aligned structs
+			byte[] data = new byte[m_SnapshotSize];
+
+			for (uint i = 0; i < m_SnapshotSize; i += 4)
+			{
+				uint value = m_Connection.Cmd_Emu_Read32(m_SnapshotAddr + i);
+				BitConverter.GetBytes(value).CopyTo(data, i);
+			}
+
+			return new RogueSnapshot(data);
+		}
+
+		public bool LoadSnapshot(RogueSnapshot snapshot)
+		{
+			if (snapshot.Data.Length != m_SnapshotSize)
+			{
+				Console.Error.WriteLine($"Snapshot is {snapshot.Data.Length} bytes but the game expects {m_SnapshotSize}");
+				return false;
+			}
+
+			for (uint i = 0; i < m_SnapshotSize; i += 4)
+				m_Connection.Cmd_Emu_Write32(m_SnapshotAddr + i, BitConverter.ToUInt32(snapshot.Data, (int)i));
+
+			if (PushCmd(CommandCode.LoadSnapshot))
+				return ReadReturnValue() != 0;
+
+			return false;
+		}
 	}
 }
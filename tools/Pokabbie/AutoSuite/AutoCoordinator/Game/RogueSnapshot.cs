@@ -0,0 +1,155 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+
+namespace AutoCoordinator.Game
+{
+	/// <summary>
+	/// Wrapper for the snapshot blob written by the SaveSnapshot automation command
+	/// </summary>
+	public class RogueSnapshot
+	{
+		public const uint SnapshotMagic = 0x50414E53; // "SNAP"
+
+		// Must match the SNAPSHOT_SECTION_ enum in rogue_automation.c
+		public enum Section
+		{
+			Seed,
+			Run,
+			AdvPath,
+			Global,
+			Party,
+			Bag,
+			Flags,
+			Vars,
+		}
+
+		public struct SectionInfo
+		{
+			public int Offset;
+			public int Size;
+		}
+
+		private byte[] m_Data;
+
+		public RogueSnapshot(byte[] data)
+		{
+			m_Data = data;
+		}
+
+		public byte[] Data
+		{
+			get => m_Data;
+		}
+
+		public bool IsValid
+		{
+			get => m_Data.Length >= 8 && BitConverter.ToUInt32(m_Data, 0) == SnapshotMagic;
+		}
+
+		public int Version
+		{
+			get => BitConverter.ToUInt16(m_Data, 4);
+		}
+
+		public int SectionCount
+		{
+			get => BitConverter.ToUInt16(m_Data, 6);
+		}
+
+		public SectionInfo GetSection(int index)
+		{
+			SectionInfo info;
+			info.Offset = BitConverter.ToUInt16(m_Data, 8 + 4 * index);
+			info.Size = BitConverter.ToUInt16(m_Data, 8 + 4 * index + 2);
+			return info;
+		}
+
+		public static string GetSectionName(int index)
+		{
+			return Enum.IsDefined(typeof(Section), index) ? ((Section)index).ToString() : $"Section{index}";
+		}
+
+		public static RogueSnapshot LoadFile(string filePath)
+		{
+			return new RogueSnapshot(File.ReadAllBytes(filePath));
+		}
+
+		public void SaveFile(string filePath)
+		{
+			File.WriteAllBytes(filePath, m_Data);
+		}
+
+		private static string DescribeOffset(Section section, int offset)
+		{
+			switch (section)
+			{
+				case Section.Flags:
+					return $"flags 0x{offset * 8:X}-0x{offset * 8 + 7:X}";
+
+				case Section.Vars:
+					return $"var 0x{0x4000 + offset / 2:X}";
+
+				case Section.Party:
+					return $"mon {offset / 100} +0x{offset % 100:X}";
+
+				default:
+					return $"+0x{offset:X}";
+			}
+		}
+
+		/// <summary>
+		/// Writes every difference between the two snapshots, grouped by section
+		/// </summary>
+		public static int Diff(RogueSnapshot a, RogueSnapshot b, TextWriter output, int maxPerSection = 32)
+		{
+			if (!a.IsValid || !b.IsValid)
+			{
+				output.WriteLine("Not a snapshot file");
+				return -1;
+			}
+
+			if (a.Version != b.Version || a.SectionCount != b.SectionCount || a.Data.Length != b.Data.Length)
+			{
+				output.WriteLine($"Snapshot layouts differ (version {a.Version} vs {b.Version}, {a.Data.Length} vs {b.Data.Length} bytes)");
+				return -1;
+			}
+
+			int totalDiffs = 0;
+
+			for (int i = 0; i < a.SectionCount; ++i)
+			{
+				SectionInfo section = a.GetSection(i);
+				List<int> diffs = new List<int>();
+
+				for (int j = 0; j < section.Size; ++j)
+				{
+					if (a.Data[section.Offset + j] != b.Data[section.Offset + j])
+						diffs.Add(j);
+				}
+
+				if (diffs.Count == 0)
+					continue;
+
+				output.WriteLine($"== {GetSectionName(i)} ({diffs.Count} bytes differ) ==");
+
+				for (int j = 0; j < diffs.Count && j < maxPerSection; ++j)
+				{
+					int offset = diffs[j];
+					output.WriteLine($"  {DescribeOffset((Section)i, offset)}: {a.Data[section.Offset + offset]:X2} -> {b.Data[section.Offset + offset]:X2}");
+				}
+
+				if (diffs.Count > maxPerSection)
+					output.WriteLine($"  ...and {diffs.Count - maxPerSection} more");
+
+				totalDiffs += diffs.Count;
+			}
+
+			if (totalDiffs == 0)
+				output.WriteLine("Snapshots match");
+
+			return totalDiffs;
+		}
+	}
+}
@@ -0,0 +1,154 @@
+﻿using AutoCoordinator.GameConsole;
+using System;
+using System.Collections.Generic;
+using System.Text;
+using System.Threading;
+
+namespace AutoCoordinator.Game.Tests
+{
+	/// <summary>
+	/// Feeds saves from each older version through the save migration table and checks which steps change them.
+	/// The oldest saves get a soft reset, which clears the money, bag, PC items and berry trees of the loaded save,
+	/// so run this on a scratch save.
+	/// </summary>
+	public class SaveMigrationTest : PokemonTest
+	{
+		// Must match sSaveMigrations in rogue_controller.c
+		private const int SaveMigrationCount = 3;
+
+		private const int Step_SoftResetPre_1_2 = 1 << 0;
+		private const int Step_AddValues_1_3 = 1 << 1;
+		private const int Step_FixQuests_1_3_1 = 1 << 2;
+
+		private struct MigrationCase
+		{
+			public string Name;
+			public int SaveVersion;
+			public int CompatVersion;
+			public int MigrationLevel;
+			public int ExpectedFirstStep;
+			public int ExpectedChangedSteps;
+
+			public MigrationCase(string name, int saveVersion, int compatVersion, int migrationLevel, int expectedFirstStep, int expectedChangedSteps)
+			{
+				Name = name;
+				SaveVersion = saveVersion;
+				CompatVersion = compatVersion;
+				MigrationLevel = migrationLevel;
+				ExpectedFirstStep = expectedFirstStep;
+				ExpectedChangedSteps = expectedChangedSteps;
+			}
+		}
+
+		private static readonly MigrationCase[] s_Cases = new MigrationCase[]
+		{
+			// Before ROGUE_SAVE_VERSION 5 the level field was unused, so whatever is in it must be ignored
+			new MigrationCase("v0", 0, 0, 0, 0, Step_SoftResetPre_1_2 | Step_AddValues_1_3),
+			new MigrationCase("v1", 1, 2, 0, 0, Step_SoftResetPre_1_2 | Step_AddValues_1_3),
+			new MigrationCase("v1 with junk level", 1, 2, 0xBEEF, 0, Step_SoftResetPre_1_2 | Step_AddValues_1_3),
+			new MigrationCase("v2", 2, 3, 0, 0, Step_AddValues_1_3),
+			new MigrationCase("v3 compat 4", 3, 4, 0, 0, Step_FixQuests_1_3_1),
+			new MigrationCase("v4 compat 4", 4, 4, 0, 0, Step_FixQuests_1_3_1),
+			new MigrationCase("v4 compat 5", 4, 5, 0, 0, 0),
+			new MigrationCase("v4 compat 5 with junk level", 4, 5, SaveMigrationCount, 0, 0),
+
+			// From ROGUE_SAVE_VERSION 5 only the steps past the recorded level run
+			new MigrationCase("v5 level 2 compat 4", 5, 4, 2, 2, Step_FixQuests_1_3_1),
+			new MigrationCase("v5 level 3 compat 4", 5, 4, 3, 3, 0),
+			new MigrationCase("v5 level 3", 5, 6, SaveMigrationCount, SaveMigrationCount, 0),
+		};
+
+		public SaveMigrationTest() : base("Save Migration Test")
+		{
+		}
+
+		public override void Run(PokemonGame game)
+		{
+			PokemonGame.GameInputState prevState = PokemonGame.GameInputState.Unknown;
+
+			game.ResetGame();
+
+			while (true)
+			{
+				PokemonGame.GameInputState inputState = game.GetInputState();
+
+				switch (inputState)
+				{
+					case PokemonGame.GameInputState.TitleMenu:
+						game.Connection.Cmd_Emu_TapKeys(ConsoleButtons.A);
+						break;
+
+					case PokemonGame.GameInputState.Overworld:
+						StartNextTest();
+						RunCases(game);
+						return;
+				}
+
+				if (prevState == inputState)
+					Thread.Sleep(30);
+
+				prevState = inputState;
+			}
+		}
+
+		private void RunCases(PokemonGame game)
+		{
+			RogueSnapshot original = game.SaveSnapshot();
+			int failCount = 0;
+
+			foreach (MigrationCase migrationCase in s_Cases)
+			{
+				if (!RunCase(game, migrationCase))
+					++failCount;
+			}
+
+			// Put back as much of the save as the snapshot covers
+			game.LoadSnapshot(original);
+
+			if (failCount == 0)
+				LogTestSuccess();
+			else
+				LogTestFail($"{failCount} of {s_Cases.Length} migration cases failed");
+		}
+
+		private bool RunCase(PokemonGame game, MigrationCase migrationCase)
+		{
+			// Values the first two steps overwrite, so their effects can be seen
+			const int genLimitBefore = 5;
+			const int regionDexBefore = 2;
+
+			game.SetVar(PokemonVarID.RogueEnabledGenLimit, genLimitBefore);
+			game.SetVar(PokemonVarID.RogueRegionDexLimit, regionDexBefore);
+
+			PokemonGame.SaveMigrationResult result = game.ApplySaveMigrations(migrationCase.SaveVersion, migrationCase.CompatVersion, migrationCase.MigrationLevel);
+
+			int genLimit = game.GetVar(PokemonVarID.RogueEnabledGenLimit);
+			int regionDex = game.GetVar(PokemonVarID.RogueRegionDexLimit);
+			List<string> errors = new List<string>();
+
+			if (result.FirstStep != migrationCase.ExpectedFirstStep)
+				errors.Add($"started from step {result.FirstStep}, expected {migrationCase.ExpectedFirstStep}");
+
+			if (result.ChangedSteps != migrationCase.ExpectedChangedSteps)
+				errors.Add($"changed steps 0x{result.ChangedSteps:X}, expected 0x{migrationCase.ExpectedChangedSteps:X}");
+
+			if (result.MigrationLevel != SaveMigrationCount)
+				errors.Add($"left the save at level {result.MigrationLevel}, expected {SaveMigrationCount}");
+
+			if ((migrationCase.ExpectedChangedSteps & Step_SoftResetPre_1_2) != 0 ? genLimit != 3 : genLimit != genLimitBefore)
+				errors.Add($"gen limit is {genLimit}");
+
+			if ((migrationCase.ExpectedChangedSteps & Step_AddValues_1_3) != 0 ? regionDex != 0 : regionDex != regionDexBefore)
+				errors.Add($"region dex limit is {regionDex}");
+
+			if (errors.Count == 0)
+			{
+				LogTestMessage($"'{migrationCase.Name}': ok");
+				return true;
+			}
+
+			LogTestMessage($"'{migrationCase.Name}': {string.Join(", ", errors)}");
+			return false;
+		}
+	}
+}
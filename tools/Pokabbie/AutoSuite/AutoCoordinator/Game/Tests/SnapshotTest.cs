@@ -0,0 +1,116 @@
+﻿using AutoCoordinator.GameConsole;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+using System.Threading;
+
+namespace AutoCoordinator.Game.Tests
+{
+	public class SnapshotTest : PokemonTest
+	{
+		public SnapshotTest() : base("Snapshot Round Trip Test")
+		{
+		}
+
+		public override void Run(PokemonGame game)
+		{
+			PokemonGame.GameInputState prevState = PokemonGame.GameInputState.Unknown;
+
+			game.ResetGame();
+
+			while (true)
+			{
+				PokemonGame.GameInputState inputState = game.GetInputState();
+
+				switch (inputState)
+				{
+					case PokemonGame.GameInputState.TitleMenu:
+						game.Connection.Cmd_Emu_TapKeys(ConsoleButtons.A);
+						break;
+
+					case PokemonGame.GameInputState.Overworld:
+						StartNextTest();
+						RunRoundTrip(game);
+						break;
+				}
+
+				if (prevState == inputState)
+					Thread.Sleep(30);
+
+				prevState = inputState;
+			}
+		}
+
+		private void RunRoundTrip(PokemonGame game)
+		{
+			RogueSnapshot before = game.SaveSnapshot();
+
+			if (before == null || !before.IsValid)
+			{
+				LogTestFail("SaveSnapshot didn't return a snapshot");
+				return;
+			}
+
+			// Go through a file, as that's how snapshots are normally passed around
+			string snapshotPath = Path.Combine(ScratchDir, "before.snap");
+			before.SaveFile(snapshotPath);
+			before = RogueSnapshot.LoadFile(snapshotPath);
+
+			ChangeGameState(game);
+
+			RogueSnapshot changed = game.SaveSnapshot();
+			changed.SaveFile(Path.Combine(ScratchDir, "changed.snap"));
+
+			if (LogDiff(before, changed) <= 0)
+			{
+				LogTestFail("Changing the game state didn't show up in the diff");
+				return;
+			}
+
+			if (!game.LoadSnapshot(before))
+			{
+				LogTestFail("LoadSnapshot rejected the snapshot");
+				return;
+			}
+
+			RogueSnapshot after = game.SaveSnapshot();
+			after.SaveFile(Path.Combine(ScratchDir, "after.snap"));
+
+			if (LogDiff(before, after) != 0)
+			{
+				LogTestFail("Loading the snapshot didn't restore the game state");
+				return;
+			}
+
+			LogTestSuccess();
+		}
+
+		private void ChangeGameState(PokemonGame game)
+		{
+			int seed0 = RNG.Next(0, ushort.MaxValue + 1);
+			int seed1 = RNG.Next(0, ushort.MaxValue + 1);
+			LogTestMessage($"Setting Rogue Seed: {seed0}, {seed1}");
+			game.SetRogueSeed(seed0, seed1);
+
+			int teamSize = RNG.Next(1, 7);
+			game.ClearPlayerParty();
+			game.GeneratePlayerParty(265, teamSize);
+			LogPlayerPartyInfo(game, teamSize);
+
+			game.SetFlag(PokemonFlagID.RogueDoubleBattles, !game.GetFlag(PokemonFlagID.RogueDoubleBattles));
+			game.SetVar(PokemonVarID.RogueSkipToDifficulty, (game.GetVar(PokemonVarID.RogueSkipToDifficulty) + 1) % 13);
+		}
+
+		private int LogDiff(RogueSnapshot a, RogueSnapshot b)
+		{
+			StringWriter output = new StringWriter();
+			int diffCount = RogueSnapshot.Diff(a, b, output);
+
+			foreach (string line in output.ToString().Split(Environment.NewLine, StringSplitOptions.RemoveEmptyEntries))
+				LogTestMessage(line);
+
+			return diffCount;
+		}
+	}
+}
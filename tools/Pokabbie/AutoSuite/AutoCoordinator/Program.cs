@@ -12,6 +12,12 @@ namespace AutoCoordinator
 
 		static void Main(string[] args)
 		{
+			if (args.Length == 3 && args[0] == "diff")
+			{
+				RogueSnapshot.Diff(RogueSnapshot.LoadFile(args[1]), RogueSnapshot.LoadFile(args[2]), Console.Out);
+				return;
+			}
+
 			List<PokemonTest> avaliableTests = new List<PokemonTest>();
 
 			foreach (var testClass in Assembly.GetEntryAssembly().GetTypes().Where((t) => t.IsSubclassOf(typeof(PokemonTest)) && !t.IsAbstract))
@@ -0,0 +1,87 @@
+-- mGBA script for builds with ROGUE_FEATURE_PROFILER enabled.
+-- Dumps the profiler's per-frame trace to a CSV file every time the ring buffer fills.
+--
+-- Set headerAddr to the address of gRogueProfilerHeader, e.g. from
+--   grep gRogueProfilerHeader pokeemerald.sym
+
+constants =
+{
+    headerAddr = 0x00000000,
+    outputPath = "profiler_trace.csv",
+    sectionNames = { "tasks", "anim", "oam", "fade", "script", "party", "advpath" },
+}
+
+profilerState =
+{
+    file = nil,
+    lastFrame = 0,
+}
+
+function readHeader()
+    local addr = constants.headerAddr
+    return {
+        frameCapacity = emu:read32(addr + 0),
+        sectionCount = emu:read32(addr + 4),
+        tickCycles = emu:read32(addr + 8),
+        frames = emu:read32(addr + 12),
+        frameCount = emu:read32(addr + 16),
+    }
+end
+
+function writeCsvHeader(header)
+    local line = "frame,total"
+    for i = 1, header.sectionCount do
+        line = line .. "," .. (constants.sectionNames[i] or ("section" .. i))
+    end
+    profilerState.file:write(line .. "\n")
+end
+
+function dumpFrames(header, fromFrame, toFrame)
+    local recordSize = 2 * (1 + header.sectionCount)
+
+    -- Anything older than the ring buffer has been overwritten
+    if toFrame - fromFrame > header.frameCapacity then
+        fromFrame = toFrame - header.frameCapacity
+    end
+
+    for frame = fromFrame, toFrame - 1 do
+        local record = header.frames + (frame % header.frameCapacity) * recordSize
+        local line = tostring(frame)
+
+        for i = 0, header.sectionCount do
+            line = line .. "," .. tostring(emu:read16(record + i * 2) * header.tickCycles)
+        end
+
+        profilerState.file:write(line .. "\n")
+    end
+end
+
+function onFrame()
+    local header = readHeader()
+    local frameCount = emu:read32(header.frameCount)
+
+    if frameCount < profilerState.lastFrame then
+        -- Game was reset
+        profilerState.lastFrame = 0
+    end
+
+    if frameCount - profilerState.lastFrame >= header.frameCapacity / 2 then
+        dumpFrames(header, profilerState.lastFrame, frameCount)
+        profilerState.file:flush()
+        profilerState.lastFrame = frameCount
+    end
+end
+
+function onStart()
+    profilerState.file = io.open(constants.outputPath, "w")
+    writeCsvHeader(readHeader())
+    profilerState.lastFrame = 0
+    console:log("Writing profiler trace to " .. constants.outputPath)
+end
+
+callbacks:add("start", onStart)
+callbacks:add("frame", onFrame)
+
+if emu then
+    onStart()
+end
@@ -24,6 +24,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <limits.h>
+#include <dirent.h>
+#include <sys/stat.h>
 
 /* extended.c */
 void ieee754_write_extended (double, uint8_t*);
@@ -51,10 +53,7 @@ do                                          \
 
 typedef struct {
 	unsigned long num_samples;
-	union {
-		uint8_t *samples8;
-		uint16_t *samples16;
-	};
+	uint8_t *samples8;
 	uint8_t midi_note;
 	uint8_t sample_size;
 	bool has_loop;
@@ -140,38 +139,98 @@ char *new_file_extension(char *filename, char *ext)
 	return new_filename;
 }
 
-void read_aif(struct Bytes *aif, AifData *aif_data)
+#define AIF_READ_BLOCK_SIZE 0x10000
+
+static uint16_t load_u16_be(const uint8_t *src)
+{
+	return (src[0] << 8) | src[1];
+}
+
+static uint32_t load_u32_be(const uint8_t *src)
+{
+	return ((uint32_t)src[0] << 24) | (src[1] << 16) | (src[2] << 8) | src[3];
+}
+
+static void read_exact(FILE *f, void *dest, unsigned long size, const char *filename)
+{
+	if (size != 0 && fread(dest, size, 1, f) != 1)
+	{
+		FATAL_ERROR("Failed to read data from '%s'!\n", filename);
+	}
+}
+
+// Streams the SSND sound data into 8-bit samples. 16-bit samples are
+// big-endian, so their high byte is the first of each pair.
+static void read_sound_data(FILE *f, const char *filename, unsigned long size, AifData *aif_data)
+{
+	bool is_16bit = aif_data->sample_size != 8;
+	unsigned long num_samples = is_16bit ? size / 2 : size;
+	uint8_t *samples = malloc(num_samples + 1);
+
+	if (is_16bit)
+	{
+		uint8_t *block = malloc(AIF_READ_BLOCK_SIZE);
+		unsigned long done = 0;
+		while (done < size)
+		{
+			unsigned long block_size = size - done < AIF_READ_BLOCK_SIZE ? size - done : AIF_READ_BLOCK_SIZE;
+			read_exact(f, block, block_size, filename);
+			for (unsigned long i = 0; i + 1 < block_size; i += 2)
+			{
+				samples[(done + i) / 2] = block[i];
+			}
+			done += block_size;
+		}
+		free(block);
+	}
+	else
+	{
+		read_exact(f, samples, size, filename);
+	}
+
+	aif_data->samples8 = samples;
+	aif_data->real_num_samples = num_samples;
+}
+
+// Reads an .aif file chunk by chunk. Only the small header chunks are loaded
+// into memory whole; the sound data goes straight into the sample buffer and
+// unsupported chunks are skipped without being read.
+void read_aif(const char *filename, AifData *aif_data)
 {
 	aif_data->has_loop = false;
 	aif_data->num_samples = 0;
 
-	unsigned long pos = 0;
+	FILE *f = fopen(filename, "rb");
+	if (!f)
+	{
+		FATAL_ERROR("Failed to open '%s' for reading!\n", filename);
+	}
+	fseek(f, 0, SEEK_END);
+	unsigned long file_length = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	uint8_t header[12];
 	char chunk_name[5]; chunk_name[4] = '\0';
 	char chunk_type[5]; chunk_type[4] = '\0';
 
 	// Check for FORM Chunk
-	memcpy(chunk_name, &aif->data[pos], 4);
-	pos += 4;
+	read_exact(f, header, sizeof(header), filename);
+	memcpy(chunk_name, &header[0], 4);
 	if (strcmp(chunk_name, "FORM") != 0)
 	{
 		FATAL_ERROR("Input .aif file has invalid header Chunk '%s'!\n", chunk_name);
 	}
 
 	// Read size of whole file.
-	unsigned long whole_chunk_size = aif->data[pos++] << 24;
-	whole_chunk_size |= (aif->data[pos++] << 16);
-	whole_chunk_size |= (aif->data[pos++] <<  8);
-	whole_chunk_size |= (uint8_t)aif->data[pos++];
-
-	unsigned long expected_whole_chunk_size = aif->length - 8;
+	unsigned long whole_chunk_size = load_u32_be(&header[4]);
+	unsigned long expected_whole_chunk_size = file_length - 8;
 	if (whole_chunk_size != expected_whole_chunk_size)
 	{
 		FATAL_ERROR("FORM Chunk ckSize '%lu' doesn't match actual size '%lu'!\n", whole_chunk_size, expected_whole_chunk_size);
 	}
 
 	// Check for AIFF Form Type
-	memcpy(chunk_type, &aif->data[pos], 4);
-	pos += 4;
+	memcpy(chunk_type, &header[8], 4);
 	if (strcmp(chunk_type, "AIFF") != 0)
 	{
 		FATAL_ERROR("FORM Type is '%s', but it must be AIFF!", chunk_type);
@@ -180,49 +239,64 @@ void read_aif(struct Bytes *aif, AifData *aif_data)
 	struct Marker *markers = NULL;
 	unsigned short num_markers = 0, loop_start = 0, loop_end = 0;
 	unsigned long num_sample_frames = 0;
+	unsigned long pos = sizeof(header);
 
 	// Read all the Chunks to populate the AifData struct.
-	while ((pos + 8) < aif->length)
+	while ((pos + 8) < file_length)
 	{
 		// Read Chunk id
-		memcpy(chunk_name, &aif->data[pos], 4);
-		pos += 4;
+		uint8_t chunk_header[8];
+		read_exact(f, chunk_header, sizeof(chunk_header), filename);
+		memcpy(chunk_name, &chunk_header[0], 4);
+		pos += 8;
 
-		unsigned long chunk_size = (aif->data[pos++] << 24);
-		chunk_size |= (aif->data[pos++] << 16);
-		chunk_size |= (aif->data[pos++] <<  8);
-		chunk_size |=  aif->data[pos++];
+		unsigned long chunk_size = load_u32_be(&chunk_header[4]);
 
-		if ((pos + chunk_size) > aif->length)
+		if ((pos + chunk_size) > file_length)
 		{
 			FATAL_ERROR("%s chunk at 0x%lx reached end of file before finishing\n", chunk_name, pos);
 		}
 
+		if (strcmp(chunk_name, "SSND") == 0)
+		{
+			// Skip offset and blockSize
+			uint8_t ssnd_header[8];
+			read_exact(f, ssnd_header, sizeof(ssnd_header), filename);
+			read_sound_data(f, filename, chunk_size - 8, aif_data);
+			pos += chunk_size;
+			continue;
+		}
+		else if (strcmp(chunk_name, "COMM") != 0 && strcmp(chunk_name, "MARK") != 0 && strcmp(chunk_name, "INST") != 0)
+		{
+			// Skip over unsupported chunks.
+			fseek(f, chunk_size, SEEK_CUR);
+			pos += chunk_size;
+			continue;
+		}
+
+		// The remaining chunks are small enough to load whole. Marker names
+		// can run past the declared size by a byte, so leave some slack.
+		uint8_t *chunk = calloc(chunk_size + 0x100, 1);
+		read_exact(f, chunk, chunk_size, filename);
+		unsigned long chunk_pos = 0;
+
 		if (strcmp(chunk_name, "COMM") == 0)
 		{
-			short num_channels = (aif->data[pos++] << 8);
-			num_channels |= (uint8_t)aif->data[pos++];
+			short num_channels = load_u16_be(&chunk[0]);
 			if (num_channels != 1)
 			{
 				FATAL_ERROR("numChannels (%d) in the COMM Chunk must be 1!\n", num_channels);
 			}
 
-			num_sample_frames =  (aif->data[pos++] << 24);
-			num_sample_frames |= (aif->data[pos++] << 16);
-			num_sample_frames |= (aif->data[pos++] <<  8);
-			num_sample_frames |=  (uint8_t)aif->data[pos++];
+			num_sample_frames = load_u32_be(&chunk[2]);
 
-			aif_data->sample_size = (aif->data[pos++] << 8);
-			aif_data->sample_size |= (uint8_t)aif->data[pos++];
+			aif_data->sample_size = load_u16_be(&chunk[6]);
 			if (aif_data->sample_size != 8 && aif_data->sample_size != 16)
 			{
 				FATAL_ERROR("sampleSize (%d) in the COMM Chunk must be 8 or 16!\n", aif_data->sample_size);
 			}
 
-			double sample_rate = ieee754_read_extended((uint8_t*)(aif->data + pos));
-			pos += 10;
-
-			aif_data->sample_rate = sample_rate;
+			aif_data->sample_rate = ieee754_read_extended(&chunk[8]);
 
 			if (aif_data->num_samples == 0)
 			{
@@ -231,110 +305,55 @@ void read_aif(struct Bytes *aif, AifData *aif_data)
 		}
 		else if (strcmp(chunk_name, "MARK") == 0)
 		{
-			num_markers = (aif->data[pos++] << 8);
-			num_markers |= (uint8_t)aif->data[pos++];
+			num_markers = load_u16_be(&chunk[chunk_pos]);
+			chunk_pos += 2;
 
 			if (markers)
 			{
 				FATAL_ERROR("More than one MARK Chunk in file!\n");
 			}
-			
+
 			markers = calloc(num_markers, sizeof(struct Marker));
 
 			// Read each marker.
-			for (int i = 0; i < num_markers; i++)
+			for (int i = 0; i < num_markers && chunk_pos + 7 <= chunk_size; i++)
 			{
-				unsigned short marker_id = (aif->data[pos++] << 8);
-				marker_id |= (uint8_t)aif->data[pos++];
-
-				unsigned long marker_position = (aif->data[pos++] << 24);
-				marker_position |= (aif->data[pos++] << 16);
-				marker_position |= (aif->data[pos++] << 8);
-				marker_position |=  (uint8_t)aif->data[pos++];
-
-				// Marker name is a Pascal-style string.
-				uint8_t marker_name_size = aif->data[pos++];
-				// We don't actually need the marker name for anything anymore.
-				/*char *marker_name = (char *)malloc((marker_name_size + 1) * sizeof(char));
-				memcpy(marker_name, &aif->data[pos], marker_name_size);
-				marker_name[marker_name_size] = '\0';*/
-				pos += marker_name_size + !(marker_name_size & 1);
-
-				markers[i].id = marker_id;
-				markers[i].position = marker_position;
+				markers[i].id = load_u16_be(&chunk[chunk_pos]);
+				markers[i].position = load_u32_be(&chunk[chunk_pos + 2]);
+				chunk_pos += 6;
+
+				// Marker name is a Pascal-style string. We don't need it.
+				uint8_t marker_name_size = chunk[chunk_pos++];
+				chunk_pos += marker_name_size + !(marker_name_size & 1);
 			}
 		}
 		else if (strcmp(chunk_name, "INST") == 0)
 		{
-			uint8_t midi_note = (uint8_t)aif->data[pos++];
-
-			aif_data->midi_note = midi_note;
+			aif_data->midi_note = chunk[0];
 
 			// Skip over data we don't need.
-			pos += 7;
-
-			unsigned short loop_type = (aif->data[pos++] << 8);
-			loop_type |= (uint8_t)aif->data[pos++];
+			unsigned short loop_type = load_u16_be(&chunk[8]);
 
 			if (loop_type)
 			{
-				loop_start = (aif->data[pos++] << 8);
-				loop_start |= (uint8_t)aif->data[pos++];
-
-				loop_end = (aif->data[pos++] << 8);
-				loop_end |= (uint8_t)aif->data[pos++];
-			}
-			else
-			{
-				// Skip NoLooping sustain loop.
-				pos += 4;
+				loop_start = load_u16_be(&chunk[10]);
+				loop_end = load_u16_be(&chunk[12]);
 			}
-			
-			// Skip release loop, we don't need it.
-			pos += 6;
-		}
-		else if (strcmp(chunk_name, "SSND") == 0)
-		{
-			// Skip offset and blockSize
-			pos += 8;
 
-			unsigned long num_samples = chunk_size - 8;
-			if (aif_data->sample_size == 8)
-			{
-				uint8_t *sample_data = (uint8_t *)malloc(num_samples * sizeof(uint8_t));
-				memcpy(sample_data, &aif->data[pos], num_samples);
-	
-				aif_data->samples8 = sample_data;
-				aif_data->real_num_samples = num_samples;
-			}
-			else
-			{
-				uint16_t *sample_data = (uint16_t *)malloc(num_samples * sizeof(uint16_t));
-				uint16_t *sample_data_swapped = (uint16_t *)malloc(num_samples * sizeof(uint16_t));
-				memcpy(sample_data, &aif->data[pos], num_samples);
-				for (long unsigned i = 0; i < num_samples; i++)
-				{
-					sample_data_swapped[i] = __builtin_bswap16(sample_data[i]);
-				}
-	
-				aif_data->samples16 = sample_data_swapped;
-				aif_data->real_num_samples = num_samples;
-				free(sample_data);
-			}
-			pos += chunk_size - 8;
-		}
-		else
-		{
-			// Skip over unsupported chunks.
-			pos += chunk_size;
+			// The release loop isn't needed.
 		}
+
+		free(chunk);
+		pos += chunk_size;
 	}
-	
+
+	fclose(f);
+
 	if (markers)
 	{
 		// Resolve loop points.
 		struct Marker *cur_marker = markers;
-	
+
 		// Grab loop start point.
 		for (int i = 0; i < num_markers; i++, cur_marker++)
 		{
@@ -482,8 +501,33 @@ int get_delta_index(uint8_t sample, uint8_t prev_sample)
 	return best_index;
 }
 
+// get_delta_index only depends on the two sample values, so every answer is
+// computed once up front and compression becomes a table lookup per sample.
+static uint8_t delta_index_table[256][256]; // [prev_sample][sample]
+static bool delta_index_table_ready;
+
+static void init_delta_index_table(void)
+{
+	if (delta_index_table_ready)
+	{
+		return;
+	}
+
+	for (int prev_sample = 0; prev_sample < 256; prev_sample++)
+	{
+		for (int sample = 0; sample < 256; sample++)
+		{
+			delta_index_table[prev_sample][sample] = get_delta_index(sample, prev_sample);
+		}
+	}
+
+	delta_index_table_ready = true;
+}
+
 struct Bytes *delta_compress(struct Bytes *pcm)
 {
+	init_delta_index_table();
+
 	struct Bytes *delta = malloc(sizeof(struct Bytes));
 	// estimate the length so we can malloc
 	int num_blocks = pcm->length / 64;
@@ -522,7 +566,7 @@ struct Bytes *delta_compress(struct Bytes *pcm)
 		{
 			break;
 		}
-		delta_index = get_delta_index(pcm->data[i++], base);
+		delta_index = delta_index_table[base][pcm->data[i++]];
 		base += gDeltaEncodingTable[delta_index];
 		delta->data[j++] = delta_index;
 
@@ -532,7 +576,7 @@ struct Bytes *delta_compress(struct Bytes *pcm)
 			{
 				break;
 			}
-			delta_index = get_delta_index(pcm->data[i++], base);
+			delta_index = delta_index_table[base][pcm->data[i++]];
 			base += gDeltaEncodingTable[delta_index];
 			delta->data[j] = (delta_index << 4);
 
@@ -540,7 +584,7 @@ struct Bytes *delta_compress(struct Bytes *pcm)
 			{
 				break;
 			}
-			delta_index = get_delta_index(pcm->data[i++], base);
+			delta_index = delta_index_table[base][pcm->data[i++]];
 			base += gDeltaEncodingTable[delta_index];
 			delta->data[j++] |= delta_index;
 		}
@@ -570,22 +614,8 @@ do { \
 // Reads an .aif file and produces a .pcm file containing an array of 8-bit samples.
 void aif2pcm(const char *aif_filename, const char *pcm_filename, bool compress)
 {
-	struct Bytes *aif = read_bytearray(aif_filename);
 	AifData aif_data = {0};
-	read_aif(aif, &aif_data);
-	
-	// Convert 16-bit to 8-bit if necessary
-	if (aif_data.sample_size == 16)
-	{
-		aif_data.real_num_samples /= 2;
-		uint8_t *converted_samples = malloc(aif_data.real_num_samples * sizeof(uint8_t));
-		for (unsigned long i = 0; i < aif_data.real_num_samples; i++)
-		{
-			converted_samples[i] = aif_data.samples16[i] >> 8;
-		}
-		free(aif_data.samples16);
-		aif_data.samples8 = converted_samples;
-	}
+	read_aif(aif_filename, &aif_data);
 
 	int header_size = 0x10;
 	struct Bytes *pcm;
@@ -621,8 +651,10 @@ void aif2pcm(const char *aif_filename, const char *pcm_filename, bool compress)
 	memcpy(&output.data[header_size], pcm->data, pcm->length);
 	write_bytearray(pcm_filename, &output);
 
-	free(aif->data);
-	free(aif);
+	if (compress)
+	{
+		free(pcm->data);
+	}
 	free(pcm);
 	free(output.data);
 	free(aif_data.samples8);
@@ -878,10 +910,58 @@ void pcm2aif(const char *pcm_filename, const char *aif_filename, uint32_t base_n
 	free(aif);
 }
 
+// Converts every .aif file in a directory to a .bin next to it, skipping
+// samples whose .bin is at least as new as the .aif. This rebuilds a whole
+// sample bank in one process instead of one process per sample.
+void aif2pcm_batch(const char *dirname, bool compress)
+{
+	DIR *dir = opendir(dirname);
+	if (!dir)
+	{
+		FATAL_ERROR("Failed to open directory '%s'!\n", dirname);
+	}
+
+	int num_converted = 0;
+	int num_skipped = 0;
+	struct dirent *entry;
+
+	while ((entry = readdir(dir)) != NULL)
+	{
+		char *extension = get_file_extension(entry->d_name);
+		if (!extension || (strcmp(extension, "aif") != 0 && strcmp(extension, "aiff") != 0))
+		{
+			continue;
+		}
+
+		char *aif_filename = malloc(strlen(dirname) + 1 + strlen(entry->d_name) + 1);
+		sprintf(aif_filename, "%s/%s", dirname, entry->d_name);
+		char *bin_filename = new_file_extension(aif_filename, "bin");
+
+		struct stat aif_stat, bin_stat;
+		if (stat(aif_filename, &aif_stat) == 0 && stat(bin_filename, &bin_stat) == 0
+		 && bin_stat.st_mtime >= aif_stat.st_mtime)
+		{
+			num_skipped++;
+		}
+		else
+		{
+			aif2pcm(aif_filename, bin_filename, compress);
+			num_converted++;
+		}
+
+		free(bin_filename);
+		free(aif_filename);
+	}
+
+	closedir(dir);
+	printf("aif2pcm: %s: converted %d, up to date %d\n", dirname, num_converted, num_skipped);
+}
+
 void usage(void)
 {
 	fprintf(stderr, "Usage: aif2pcm bin_file [aif_file]\n");
 	fprintf(stderr, "       aif2pcm aif_file [bin_file] [--compress]\n");
+	fprintf(stderr, "       aif2pcm --batch aif_dir [--compress]\n");
 }
 
 int main(int argc, char **argv)
@@ -892,6 +972,17 @@ int main(int argc, char **argv)
 		exit(1);
 	}
 
+	if (strcmp(argv[1], "--batch") == 0)
+	{
+		if (argc < 3)
+		{
+			usage();
+			exit(1);
+		}
+		aif2pcm_batch(argv[2], argc > 3 && strcmp(argv[3], "--compress") == 0);
+		return 0;
+	}
+
 	char *input_file = argv[1];
 	char *extension = get_file_extension(input_file);
 	char *output_file;
@@ -36,6 +36,319 @@ static void AdvanceMetatilePosition(int *subTileX, int *subTileY, int *metatileX
 	}
 }
 
+// Word-at-a-time helpers. A tile row is 1, 4 or 8 bytes wide depending on the
+// bit depth, so each row of a tile fits in a single machine word.
+
+static inline uint32_t LoadU32(const unsigned char *p)
+{
+	uint32_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+static inline void StoreU32(unsigned char *p, uint32_t value)
+{
+	memcpy(p, &value, sizeof(value));
+}
+
+static inline uint64_t LoadU64(const unsigned char *p)
+{
+	uint64_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+static inline void StoreU64(unsigned char *p, uint64_t value)
+{
+	memcpy(p, &value, sizeof(value));
+}
+
+static inline uint32_t SwapNybbles32(uint32_t x)
+{
+	return ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+}
+
+static inline uint32_t ReverseBytes32(uint32_t x)
+{
+	return (x >> 24) | ((x >> 8) & 0xFF00u) | ((x << 8) & 0xFF0000u) | (x << 24);
+}
+
+static inline uint64_t ReverseBytes64(uint64_t x)
+{
+	return ((uint64_t)ReverseBytes32((uint32_t)x) << 32) | ReverseBytes32((uint32_t)(x >> 32));
+}
+
+// Reverses the bit order of every byte in the word.
+static inline uint64_t ReverseBits64(uint64_t x)
+{
+	x = ((x >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((x & 0x0F0F0F0F0F0F0F0Full) << 4);
+	x = ((x >> 2) & 0x3333333333333333ull) | ((x & 0x3333333333333333ull) << 2);
+	x = ((x >> 1) & 0x5555555555555555ull) | ((x & 0x5555555555555555ull) << 1);
+	return x;
+}
+
+static inline unsigned char ReverseBits8(unsigned char x)
+{
+	return (unsigned char)ReverseBits64(x);
+}
+
+// Single tile kernels. "Pack" goes from linear image pixels to GBA tile data,
+// "Unpack" goes the other way. Inverting colors is a plain XOR in every
+// bit depth, since 15 - x == x ^ 0xF and 255 - x == x ^ 0xFF.
+
+static void PackTile1Bpp(const unsigned char *src, int pitch, unsigned char *dest, unsigned char xorMask)
+{
+	for (int j = 0; j < 8; j++)
+		dest[j] = ReverseBits8(src[j * pitch]) ^ xorMask;
+}
+
+static void UnpackTile1Bpp(const unsigned char *src, unsigned char *dest, int pitch, unsigned char xorMask)
+{
+	for (int j = 0; j < 8; j++)
+		dest[j * pitch] = ReverseBits8(src[j]) ^ xorMask;
+}
+
+static void PackTile4Bpp(const unsigned char *src, int pitch, unsigned char *dest, uint32_t xorMask)
+{
+	for (int j = 0; j < 8; j++)
+		StoreU32(&dest[j * 4], SwapNybbles32(LoadU32(&src[j * pitch])) ^ xorMask);
+}
+
+static void UnpackTile4Bpp(const unsigned char *src, unsigned char *dest, int pitch, uint32_t xorMask)
+{
+	for (int j = 0; j < 8; j++)
+		StoreU32(&dest[j * pitch], SwapNybbles32(LoadU32(&src[j * 4])) ^ xorMask);
+}
+
+static void PackTile8Bpp(const unsigned char *src, int pitch, unsigned char *dest, uint64_t xorMask)
+{
+	for (int j = 0; j < 8; j++)
+		StoreU64(&dest[j * 8], LoadU64(&src[j * pitch]) ^ xorMask);
+}
+
+static void UnpackTile8Bpp(const unsigned char *src, unsigned char *dest, int pitch, uint64_t xorMask)
+{
+	for (int j = 0; j < 8; j++)
+		StoreU64(&dest[j * pitch], LoadU64(&src[j * 8]) ^ xorMask);
+}
+
+// Vectorized 4bpp kernels for a horizontal run of tiles. Each one converts as
+// many whole groups of tiles as it can and returns how many it handled; the
+// caller finishes the rest with the single tile kernels above.
+//
+// In linear order, pixel row j of consecutive tiles is one contiguous run of
+// 4-byte words, while in tile order it is the rows of one tile that are
+// contiguous. Converting between the two is therefore a 4x4 transpose of
+// 32-bit words, done twice per group (rows 0-3 and rows 4-7).
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define GFX_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(GFX_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GFX_AVX2
+#include <immintrin.h>
+#endif
+
+#ifdef GFX_SSE2
+
+static inline __m128i SwapNybblesSse2(__m128i v, __m128i lowMask)
+{
+	return _mm_or_si128(_mm_and_si128(_mm_srli_epi16(v, 4), lowMask), _mm_slli_epi16(_mm_and_si128(v, lowMask), 4));
+}
+
+static inline void Transpose4x4Sse2(__m128i *v)
+{
+	__m128i t0 = _mm_unpacklo_epi32(v[0], v[1]);
+	__m128i t1 = _mm_unpacklo_epi32(v[2], v[3]);
+	__m128i t2 = _mm_unpackhi_epi32(v[0], v[1]);
+	__m128i t3 = _mm_unpackhi_epi32(v[2], v[3]);
+
+	v[0] = _mm_unpacklo_epi64(t0, t1);
+	v[1] = _mm_unpackhi_epi64(t0, t1);
+	v[2] = _mm_unpacklo_epi64(t2, t3);
+	v[3] = _mm_unpackhi_epi64(t2, t3);
+}
+
+static int PackTileRun4BppSse2(const unsigned char *src, int pitch, unsigned char *dest, int count, uint32_t xorMask)
+{
+	const __m128i lowMask = _mm_set1_epi8(0x0F);
+	const __m128i invert = _mm_set1_epi32((int)xorMask);
+	int i;
+
+	for (i = 0; i + 4 <= count; i += 4) {
+		__m128i v[8];
+
+		for (int j = 0; j < 8; j++)
+			v[j] = _mm_xor_si128(SwapNybblesSse2(_mm_loadu_si128((const __m128i *)&src[j * pitch + i * 4]), lowMask), invert);
+
+		Transpose4x4Sse2(&v[0]);
+		Transpose4x4Sse2(&v[4]);
+
+		for (int t = 0; t < 4; t++) {
+			_mm_storeu_si128((__m128i *)&dest[(i + t) * 32], v[t]);
+			_mm_storeu_si128((__m128i *)&dest[(i + t) * 32 + 16], v[4 + t]);
+		}
+	}
+
+	return i;
+}
+
+static int UnpackTileRun4BppSse2(const unsigned char *src, unsigned char *dest, int pitch, int count, uint32_t xorMask)
+{
+	const __m128i lowMask = _mm_set1_epi8(0x0F);
+	const __m128i invert = _mm_set1_epi32((int)xorMask);
+	int i;
+
+	for (i = 0; i + 4 <= count; i += 4) {
+		__m128i v[8];
+
+		for (int t = 0; t < 4; t++) {
+			v[t] = _mm_loadu_si128((const __m128i *)&src[(i + t) * 32]);
+			v[4 + t] = _mm_loadu_si128((const __m128i *)&src[(i + t) * 32 + 16]);
+		}
+
+		Transpose4x4Sse2(&v[0]);
+		Transpose4x4Sse2(&v[4]);
+
+		for (int j = 0; j < 8; j++)
+			_mm_storeu_si128((__m128i *)&dest[j * pitch + i * 4], _mm_xor_si128(SwapNybblesSse2(v[j], lowMask), invert));
+	}
+
+	return i;
+}
+
+#endif // GFX_SSE2
+
+#ifdef GFX_AVX2
+
+static bool CpuHasAvx2(void)
+{
+	static int hasAvx2 = -1;
+
+	if (hasAvx2 < 0) {
+		__builtin_cpu_init();
+		hasAvx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+	}
+
+	return hasAvx2;
+}
+
+__attribute__((target("avx2")))
+static inline __m256i SwapNybblesAvx2(__m256i v, __m256i lowMask)
+{
+	return _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask), _mm256_slli_epi16(_mm256_and_si256(v, lowMask), 4));
+}
+
+// Same as Transpose4x4Sse2, independently in each 128-bit lane.
+__attribute__((target("avx2")))
+static inline void Transpose4x4Avx2(__m256i *v)
+{
+	__m256i t0 = _mm256_unpacklo_epi32(v[0], v[1]);
+	__m256i t1 = _mm256_unpacklo_epi32(v[2], v[3]);
+	__m256i t2 = _mm256_unpackhi_epi32(v[0], v[1]);
+	__m256i t3 = _mm256_unpackhi_epi32(v[2], v[3]);
+
+	v[0] = _mm256_unpacklo_epi64(t0, t1);
+	v[1] = _mm256_unpackhi_epi64(t0, t1);
+	v[2] = _mm256_unpacklo_epi64(t2, t3);
+	v[3] = _mm256_unpackhi_epi64(t2, t3);
+}
+
+// 8 tiles per iteration. After the in-lane transpose, the low lane holds
+// tiles 0-3 and the high lane holds tiles 4-7, so the halves of each tile are
+// stitched back together with a cross-lane permute.
+__attribute__((target("avx2")))
+static int PackTileRun4BppAvx2(const unsigned char *src, int pitch, unsigned char *dest, int count, uint32_t xorMask)
+{
+	const __m256i lowMask = _mm256_set1_epi8(0x0F);
+	const __m256i invert = _mm256_set1_epi32((int)xorMask);
+	int i;
+
+	for (i = 0; i + 8 <= count; i += 8) {
+		__m256i v[8];
+
+		for (int j = 0; j < 8; j++)
+			v[j] = _mm256_xor_si256(SwapNybblesAvx2(_mm256_loadu_si256((const __m256i *)&src[j * pitch + i * 4]), lowMask), invert);
+
+		Transpose4x4Avx2(&v[0]);
+		Transpose4x4Avx2(&v[4]);
+
+		for (int t = 0; t < 4; t++) {
+			_mm256_storeu_si256((__m256i *)&dest[(i + t) * 32], _mm256_permute2x128_si256(v[t], v[4 + t], 0x20));
+			_mm256_storeu_si256((__m256i *)&dest[(i + t + 4) * 32], _mm256_permute2x128_si256(v[t], v[4 + t], 0x31));
+		}
+	}
+
+	return i;
+}
+
+__attribute__((target("avx2")))
+static int UnpackTileRun4BppAvx2(const unsigned char *src, unsigned char *dest, int pitch, int count, uint32_t xorMask)
+{
+	const __m256i lowMask = _mm256_set1_epi8(0x0F);
+	const __m256i invert = _mm256_set1_epi32((int)xorMask);
+	int i;
+
+	for (i = 0; i + 8 <= count; i += 8) {
+		__m256i v[8];
+
+		for (int t = 0; t < 4; t++) {
+			__m256i a = _mm256_loadu_si256((const __m256i *)&src[(i + t) * 32]);
+			__m256i b = _mm256_loadu_si256((const __m256i *)&src[(i + t + 4) * 32]);
+			v[t] = _mm256_permute2x128_si256(a, b, 0x20);
+			v[4 + t] = _mm256_permute2x128_si256(a, b, 0x31);
+		}
+
+		Transpose4x4Avx2(&v[0]);
+		Transpose4x4Avx2(&v[4]);
+
+		for (int j = 0; j < 8; j++)
+			_mm256_storeu_si256((__m256i *)&dest[j * pitch + i * 4], _mm256_xor_si256(SwapNybblesAvx2(v[j], lowMask), invert));
+	}
+
+	return i;
+}
+
+#endif // GFX_AVX2
+
+static void PackTileRun4Bpp(const unsigned char *src, int pitch, unsigned char *dest, int count, uint32_t xorMask)
+{
+	int i = 0;
+
+#ifdef GFX_AVX2
+	if (CpuHasAvx2())
+		i += PackTileRun4BppAvx2(src, pitch, dest, count, xorMask);
+#endif
+#ifdef GFX_SSE2
+	i += PackTileRun4BppSse2(&src[i * 4], pitch, &dest[i * 32], count - i, xorMask);
+#endif
+
+	for (; i < count; i++)
+		PackTile4Bpp(&src[i * 4], pitch, &dest[i * 32], xorMask);
+}
+
+static void UnpackTileRun4Bpp(const unsigned char *src, unsigned char *dest, int pitch, int count, uint32_t xorMask)
+{
+	int i = 0;
+
+#ifdef GFX_AVX2
+	if (CpuHasAvx2())
+		i += UnpackTileRun4BppAvx2(src, dest, pitch, count, xorMask);
+#endif
+#ifdef GFX_SSE2
+	i += UnpackTileRun4BppSse2(&src[i * 32], &dest[i * 4], pitch, count - i, xorMask);
+#endif
+
+	for (; i < count; i++)
+		UnpackTile4Bpp(&src[i * 32], &dest[i * 4], pitch, xorMask);
+}
+
+// With 1x1 metatiles (the default, and by far the most common layout) tiles
+// are stored in plain reading order, so a whole row of tiles can be handed to
+// the run kernels at once instead of stepping through AdvanceMetatilePosition.
+
 static void ConvertFromTiles1Bpp(unsigned char *src, unsigned char *dest, int numTiles, int metatilesWide, int metatileWidth, int metatileHeight, bool invertColors)
 {
 	int subTileX = 0;
@@ -43,20 +356,14 @@ static void ConvertFromTiles1Bpp(unsigned char *src, unsigned char *dest, int nu
 	int metatileX = 0;
 	int metatileY = 0;
 	int pitch = metatilesWide * metatileWidth;
+	unsigned char xorMask = invertColors ? 0xFF : 0;
 
 	for (int i = 0; i < numTiles; i++) {
-		for (int j = 0; j < 8; j++) {
-			int destY = (metatileY * metatileHeight + subTileY) * 8 + j;
-			int destX = metatileX * metatileWidth + subTileX;
-			unsigned char srcPixelOctet = *src++;
-			unsigned char *destPixelOctet = &dest[destY * pitch + destX];
-
-			for (int k = 0; k < 8; k++) {
-				*destPixelOctet <<= 1;
-				*destPixelOctet |= (srcPixelOctet & 1) ^ invertColors;
-				srcPixelOctet >>= 1;
-			}
-		}
+		int destY = (metatileY * metatileHeight + subTileY) * 8;
+		int destX = metatileX * metatileWidth + subTileX;
+
+		UnpackTile1Bpp(src, &dest[destY * pitch + destX], pitch, xorMask);
+		src += 8;
 
 		AdvanceMetatilePosition(&subTileX, &subTileY, &metatileX, &metatileY, metatilesWide, metatileWidth, metatileHeight);
 	}
@@ -69,25 +376,23 @@ static void ConvertFromTiles4Bpp(unsigned char *src, unsigned char *dest, int nu
 	int metatileX = 0;
 	int metatileY = 0;
 	int pitch = (metatilesWide * metatileWidth) * 4;
+	uint32_t xorMask = invertColors ? 0xFFFFFFFFu : 0;
 
-	for (int i = 0; i < numTiles; i++) {
-		for (int j = 0; j < 8; j++) {
-			int destY = (metatileY * metatileHeight + subTileY) * 8 + j;
+	if (metatileWidth == 1 && metatileHeight == 1) {
+		for (int i = 0; i < numTiles; i += metatilesWide) {
+			int count = numTiles - i < metatilesWide ? numTiles - i : metatilesWide;
 
-			for (int k = 0; k < 4; k++) {
-				int destX = (metatileX * metatileWidth + subTileX) * 4 + k;
-				unsigned char srcPixelPair = *src++;
-				unsigned char leftPixel = srcPixelPair & 0xF;
-				unsigned char rightPixel = srcPixelPair >> 4;
+			UnpackTileRun4Bpp(&src[i * 32], &dest[(i / metatilesWide) * 8 * pitch], pitch, count, xorMask);
+		}
+		return;
+	}
 
-				if (invertColors) {
-					leftPixel = 15 - leftPixel;
-					rightPixel = 15 - rightPixel;
-				}
+	for (int i = 0; i < numTiles; i++) {
+		int destY = (metatileY * metatileHeight + subTileY) * 8;
+		int destX = (metatileX * metatileWidth + subTileX) * 4;
 
-				dest[destY * pitch + destX] = (leftPixel << 4) | rightPixel;
-			}
-		}
+		UnpackTile4Bpp(src, &dest[destY * pitch + destX], pitch, xorMask);
+		src += 32;
 
 		AdvanceMetatilePosition(&subTileX, &subTileY, &metatileX, &metatileY, metatilesWide, metatileWidth, metatileHeight);
 	}
@@ -100,21 +405,14 @@ static void ConvertFromTiles8Bpp(unsigned char *src, unsigned char *dest, int nu
 	int metatileX = 0;
 	int metatileY = 0;
 	int pitch = (metatilesWide * metatileWidth) * 8;
+	uint64_t xorMask = invertColors ? ~0ull : 0;
 
 	for (int i = 0; i < numTiles; i++) {
-		for (int j = 0; j < 8; j++) {
-			int destY = (metatileY * metatileHeight + subTileY) * 8 + j;
+		int destY = (metatileY * metatileHeight + subTileY) * 8;
+		int destX = (metatileX * metatileWidth + subTileX) * 8;
 
-			for (int k = 0; k < 8; k++) {
-				int destX = (metatileX * metatileWidth + subTileX) * 8 + k;
-				unsigned char srcPixel = *src++;
-
-				if (invertColors)
-					srcPixel = 255 - srcPixel;
-
-				dest[destY * pitch + destX] = srcPixel;
-			}
-		}
+		UnpackTile8Bpp(src, &dest[destY * pitch + destX], pitch, xorMask);
+		src += 64;
 
 		AdvanceMetatilePosition(&subTileX, &subTileY, &metatileX, &metatileY, metatilesWide, metatileWidth, metatileHeight);
 	}
@@ -127,20 +425,14 @@ static void ConvertToTiles1Bpp(unsigned char *src, unsigned char *dest, int numT
 	int metatileX = 0;
 	int metatileY = 0;
 	int pitch = metatilesWide * metatileWidth;
+	unsigned char xorMask = invertColors ? 0xFF : 0;
 
 	for (int i = 0; i < numTiles; i++) {
-		for (int j = 0; j < 8; j++) {
-			int srcY = (metatileY * metatileHeight + subTileY) * 8 + j;
-			int srcX = metatileX * metatileWidth + subTileX;
-			unsigned char srcPixelOctet = src[srcY * pitch + srcX];
-			unsigned char *destPixelOctet = dest++;
-
-			for (int k = 0; k < 8; k++) {
-				*destPixelOctet <<= 1;
-				*destPixelOctet |= (srcPixelOctet & 1) ^ invertColors;
-				srcPixelOctet >>= 1;
-			}
-		}
+		int srcY = (metatileY * metatileHeight + subTileY) * 8;
+		int srcX = metatileX * metatileWidth + subTileX;
+
+		PackTile1Bpp(&src[srcY * pitch + srcX], pitch, dest, xorMask);
+		dest += 8;
 
 		AdvanceMetatilePosition(&subTileX, &subTileY, &metatileX, &metatileY, metatilesWide, metatileWidth, metatileHeight);
 	}
@@ -153,25 +445,23 @@ static void ConvertToTiles4Bpp(unsigned char *src, unsigned char *dest, int numT
 	int metatileX = 0;
 	int metatileY = 0;
 	int pitch = (metatilesWide * metatileWidth) * 4;
+	uint32_t xorMask = invertColors ? 0xFFFFFFFFu : 0;
 
-	for (int i = 0; i < numTiles; i++) {
-		for (int j = 0; j < 8; j++) {
-			int srcY = (metatileY * metatileHeight + subTileY) * 8 + j;
+	if (metatileWidth == 1 && metatileHeight == 1) {
+		for (int i = 0; i < numTiles; i += metatilesWide) {
+			int count = numTiles - i < metatilesWide ? numTiles - i : metatilesWide;
 
-			for (int k = 0; k < 4; k++) {
-				int srcX = (metatileX * metatileWidth + subTileX) * 4 + k;
-				unsigned char srcPixelPair = src[srcY * pitch + srcX];
-				unsigned char leftPixel = srcPixelPair >> 4;
-				unsigned char rightPixel = srcPixelPair & 0xF;
+			PackTileRun4Bpp(&src[(i / metatilesWide) * 8 * pitch], pitch, &dest[i * 32], count, xorMask);
+		}
+		return;
+	}
 
-				if (invertColors) {
-					leftPixel = 15 - leftPixel;
-					rightPixel = 15 - rightPixel;
-				}
+	for (int i = 0; i < numTiles; i++) {
+		int srcY = (metatileY * metatileHeight + subTileY) * 8;
+		int srcX = (metatileX * metatileWidth + subTileX) * 4;
 
-				*dest++ = (rightPixel << 4) | leftPixel;
-			}
-		}
+		PackTile4Bpp(&src[srcY * pitch + srcX], pitch, dest, xorMask);
+		dest += 32;
 
 		AdvanceMetatilePosition(&subTileX, &subTileY, &metatileX, &metatileY, metatilesWide, metatileWidth, metatileHeight);
 	}
@@ -184,21 +474,14 @@ static void ConvertToTiles8Bpp(unsigned char *src, unsigned char *dest, int numT
 	int metatileX = 0;
 	int metatileY = 0;
 	int pitch = (metatilesWide * metatileWidth) * 8;
+	uint64_t xorMask = invertColors ? ~0ull : 0;
 
 	for (int i = 0; i < numTiles; i++) {
-		for (int j = 0; j < 8; j++) {
-			int srcY = (metatileY * metatileHeight + subTileY) * 8 + j;
+		int srcY = (metatileY * metatileHeight + subTileY) * 8;
+		int srcX = (metatileX * metatileWidth + subTileX) * 8;
 
-			for (int k = 0; k < 8; k++) {
-				int srcX = (metatileX * metatileWidth + subTileX) * 8 + k;
-				unsigned char srcPixel = src[srcY * pitch + srcX];
-
-				if (invertColors)
-					srcPixel = 255 - srcPixel;
-
-				*dest++ = srcPixel;
-			}
-		}
+		PackTile8Bpp(&src[srcY * pitch + srcX], pitch, dest, xorMask);
+		dest += 64;
 
 		AdvanceMetatilePosition(&subTileX, &subTileY, &metatileX, &metatileY, metatilesWide, metatileWidth, metatileHeight);
 	}
@@ -212,58 +495,31 @@ static void DecodeAffineTilemap(unsigned char *input, unsigned char *output, uns
     }
 }
 
-#define REVERSE_BIT_ORDER(x) ({ \
-      ((((x) >> 7) & 1) << 0)   \
-    | ((((x) >> 6) & 1) << 1)   \
-    | ((((x) >> 5) & 1) << 2)   \
-    | ((((x) >> 4) & 1) << 3)   \
-    | ((((x) >> 3) & 1) << 4)   \
-    | ((((x) >> 2) & 1) << 5)   \
-    | ((((x) >> 1) & 1) << 6)   \
-    | ((((x) >> 0) & 1) << 7);  \
-})
-
-#define SWAP_BYTES(a, b) ({   \
-    unsigned char tmp = *(a); \
-    *(a) = *(b);              \
-    *(b) = tmp;               \
-})
-
-#define NSWAP(x) ({ (((x) >> 4) & 0xF) | (((x) << 4) & 0xF0); })
-
-#define SWAP_NYBBLES(a, b) ({        \
-    unsigned char tmp = NSWAP(*(a)); \
-    *(a) = NSWAP(*(b));              \
-    *(b) = tmp;                      \
-})
-
 static void VflipTile(unsigned char * tile, int bitDepth)
 {
     int i;
+    uint32_t row4;
+    uint64_t row8;
     switch (bitDepth)
     {
     case 1:
-        SWAP_BYTES(&tile[0], &tile[7]);
-        SWAP_BYTES(&tile[1], &tile[6]);
-        SWAP_BYTES(&tile[2], &tile[5]);
-        SWAP_BYTES(&tile[3], &tile[4]);
+        // the whole tile is a single word, one byte per row
+        StoreU64(tile, ReverseBytes64(LoadU64(tile)));
         break;
     case 4:
         for (i = 0; i < 4; i++)
         {
-            SWAP_BYTES(&tile[i + 0], &tile[i + 28]);
-            SWAP_BYTES(&tile[i + 4], &tile[i + 24]);
-            SWAP_BYTES(&tile[i + 8], &tile[i + 20]);
-            SWAP_BYTES(&tile[i + 12], &tile[i + 16]);
+            row4 = LoadU32(&tile[4 * i]);
+            StoreU32(&tile[4 * i], LoadU32(&tile[4 * (7 - i)]));
+            StoreU32(&tile[4 * (7 - i)], row4);
         }
         break;
     case 8:
-        for (i = 0; i < 8; i++)
+        for (i = 0; i < 4; i++)
         {
-            SWAP_BYTES(&tile[i + 0], &tile[i + 56]);
-            SWAP_BYTES(&tile[i + 8], &tile[i + 48]);
-            SWAP_BYTES(&tile[i + 16], &tile[i + 40]);
-            SWAP_BYTES(&tile[i + 24], &tile[i + 32]);
+            row8 = LoadU64(&tile[8 * i]);
+            StoreU64(&tile[8 * i], LoadU64(&tile[8 * (7 - i)]));
+            StoreU64(&tile[8 * (7 - i)], row8);
         }
         break;
     }
@@ -275,24 +531,15 @@ static void HflipTile(unsigned char * tile, int bitDepth)
     switch (bitDepth)
     {
     case 1:
-        for (i = 0; i < 8; i++)
-            tile[i] = REVERSE_BIT_ORDER(tile[i]);
+        StoreU64(tile, ReverseBits64(LoadU64(tile)));
         break;
     case 4:
         for (i = 0; i < 8; i++)
-        {
-            SWAP_NYBBLES(&tile[4 * i + 0], &tile[4 * i + 3]);
-            SWAP_NYBBLES(&tile[4 * i + 1], &tile[4 * i + 2]);
-        }
+            StoreU32(&tile[4 * i], SwapNybbles32(ReverseBytes32(LoadU32(&tile[4 * i]))));
         break;
     case 8:
         for (i = 0; i < 8; i++)
-        {
-            SWAP_BYTES(&tile[8 * i + 0], &tile[8 * i + 7]);
-            SWAP_BYTES(&tile[8 * i + 1], &tile[8 * i + 6]);
-            SWAP_BYTES(&tile[8 * i + 2], &tile[8 * i + 5]);
-            SWAP_BYTES(&tile[8 * i + 3], &tile[8 * i + 4]);
-        }
+            StoreU64(&tile[8 * i], ReverseBytes64(LoadU64(&tile[8 * i])));
         break;
     }
 }
@@ -448,6 +695,221 @@ void WriteImage(char *path, int numTiles, int bitDepth, int metatileWidth, int m
 	free(buffer);
 }
 
+// Tilemap encoding. Each 8x8 tile of the image is matched against the tiles
+// already emitted, including their H, V and HV flipped forms, and only tiles
+// that have not been seen in any orientation are added to the tile sheet.
+// Matching goes through a hash of the tile data, so it stays linear in the
+// number of tiles.
+
+#define TILE_HASH_EMPTY -1
+
+struct TileSet {
+	unsigned char *tiles;
+	int tileSize;
+	int numTiles;
+	int *hashTable;
+	int hashMask;
+};
+
+static uint64_t HashTile(const unsigned char *tile, int tileSize)
+{
+	// FNV-1a
+	uint64_t hash = 0xCBF29CE484222325ull;
+
+	for (int i = 0; i < tileSize; i++) {
+		hash ^= tile[i];
+		hash *= 0x100000001B3ull;
+	}
+
+	return hash;
+}
+
+static int FindTile(struct TileSet *set, const unsigned char *tile)
+{
+	int slot = HashTile(tile, set->tileSize) & set->hashMask;
+
+	while (set->hashTable[slot] != TILE_HASH_EMPTY) {
+		int index = set->hashTable[slot];
+
+		if (memcmp(&set->tiles[index * set->tileSize], tile, set->tileSize) == 0)
+			return index;
+
+		slot = (slot + 1) & set->hashMask;
+	}
+
+	return TILE_HASH_EMPTY;
+}
+
+static int AddTile(struct TileSet *set, const unsigned char *tile)
+{
+	int slot = HashTile(tile, set->tileSize) & set->hashMask;
+	int index = set->numTiles++;
+
+	while (set->hashTable[slot] != TILE_HASH_EMPTY)
+		slot = (slot + 1) & set->hashMask;
+
+	set->hashTable[slot] = index;
+	memcpy(&set->tiles[index * set->tileSize], tile, set->tileSize);
+	return index;
+}
+
+// Converts one 8x8 block of 8-bit pixels into a tile at the output bit depth.
+// For 4bpp output, the high nibble of each pixel selects the 16-color palette
+// bank; every pixel of a tile has to come from the same bank. Banks are
+// numbered the way DecodeNonAffineTilemap expands them, so that the PNG that
+// gbagfx produces from a tile sheet and tilemap converts back to the same data.
+static int EncodeTile(const unsigned char *src, int pitch, unsigned char *dest, int bitDepth, bool bankedPalette, bool invertColors, int tileX, int tileY)
+{
+	unsigned char pixels[64];
+	int bank;
+
+	for (int j = 0; j < 8; j++)
+		for (int k = 0; k < 8; k++)
+			pixels[j * 8 + k] = invertColors ? 255 - src[j * pitch + k] : src[j * pitch + k];
+
+	if (bitDepth == 8) {
+		memcpy(dest, pixels, 64);
+		return 0;
+	}
+
+	// Grayscale images are inverted as 8-bit values, which puts the bank in the
+	// high nibble the same way the decoder does.
+	bankedPalette |= invertColors;
+	bank = pixels[0] >> 4;
+
+	for (int i = 0; i < 64; i++) {
+		if ((pixels[i] >> 4) != bank) {
+			if (bankedPalette)
+				FATAL_ERROR("Tile (%d, %d) uses colors from more than one 16-color palette.\n", tileX, tileY);
+			else
+				FATAL_ERROR("Tile (%d, %d) exceeds the maximum color value for a 4bpp image.\n", tileX, tileY);
+		}
+	}
+
+	if (!bankedPalette && bank != 0)
+		FATAL_ERROR("Tile (%d, %d) exceeds the maximum color value for a 4bpp image.\n", tileX, tileY);
+
+	for (int i = 0; i < 32; i++)
+		dest[i] = (pixels[i * 2] & 0xF) | ((pixels[i * 2 + 1] & 0xF) << 4);
+
+	return bankedPalette ? 15 - bank : 0;
+}
+
+void WriteTilemapImage(char *path, char *tilemapPath, int bitDepth, int metatileWidth, int metatileHeight, struct Image *image, bool invertColors, bool isAffine, bool bankedPalette, bool report)
+{
+	int tileSize = bitDepth * 8;
+
+	if (bitDepth != 4 && bitDepth != 8)
+		FATAL_ERROR("Tilemaps can only be generated for 4bpp and 8bpp images.\n");
+
+	if (isAffine && bitDepth != 8)
+		FATAL_ERROR("affine maps are necessarily 8bpp\n");
+
+	if (image->width % 8 != 0)
+		FATAL_ERROR("The width in pixels (%d) isn't a multiple of 8.\n", image->width);
+
+	if (image->height % 8 != 0)
+		FATAL_ERROR("The height in pixels (%d) isn't a multiple of 8.\n", image->height);
+
+	int tilesWidth = image->width / 8;
+	int tilesHeight = image->height / 8;
+
+	if (tilesWidth % metatileWidth != 0)
+		FATAL_ERROR("The width in tiles (%d) isn't a multiple of the specified metatile width (%d)", tilesWidth, metatileWidth);
+
+	if (tilesHeight % metatileHeight != 0)
+		FATAL_ERROR("The height in tiles (%d) isn't a multiple of the specified metatile height (%d)", tilesHeight, metatileHeight);
+
+	int numTiles = tilesWidth * tilesHeight;
+	int hashSize = 1;
+
+	while (hashSize < numTiles * 2)
+		hashSize <<= 1;
+
+	struct TileSet set;
+	set.tiles = malloc(numTiles * tileSize);
+	set.tileSize = tileSize;
+	set.numTiles = 0;
+	set.hashTable = malloc(hashSize * sizeof(int));
+	set.hashMask = hashSize - 1;
+
+	int mapEntrySize = isAffine ? 1 : 2;
+	unsigned char *tilemap = malloc(numTiles * mapEntrySize);
+
+	if (set.tiles == NULL || set.hashTable == NULL || tilemap == NULL)
+		FATAL_ERROR("Failed to allocate memory for tilemap encoding.\n");
+
+	for (int i = 0; i < hashSize; i++)
+		set.hashTable[i] = TILE_HASH_EMPTY;
+
+	int subTileX = 0;
+	int subTileY = 0;
+	int metatileX = 0;
+	int metatileY = 0;
+	int metatilesWide = tilesWidth / metatileWidth;
+	int numFlipped = 0;
+	unsigned char tile[64];
+	unsigned char flipped[64];
+
+	for (int i = 0; i < numTiles; i++) {
+		int tileX = metatileX * metatileWidth + subTileX;
+		int tileY = metatileY * metatileHeight + subTileY;
+		int palno = EncodeTile(&image->pixels[tileY * 8 * image->width + tileX * 8], image->width, tile, bitDepth, bankedPalette, invertColors, tileX, tileY);
+		int flip = 0;
+		int index = FindTile(&set, tile);
+
+		// Try H, V and HV in turn; bit 0 of flip is hflip and bit 1 is vflip.
+		if (!isAffine) {
+			for (flip = 1; index == TILE_HASH_EMPTY && flip < 4; flip++) {
+				memcpy(flipped, tile, tileSize);
+				if (flip & 1)
+					HflipTile(flipped, bitDepth);
+				if (flip & 2)
+					VflipTile(flipped, bitDepth);
+				index = FindTile(&set, flipped);
+			}
+
+			if (index == TILE_HASH_EMPTY)
+				flip = 0;
+			else
+				flip--;
+		}
+
+		if (index == TILE_HASH_EMPTY)
+			index = AddTile(&set, tile);
+		else if (flip != 0)
+			numFlipped++;
+
+		if (isAffine) {
+			if (index > 0xFF)
+				FATAL_ERROR("Affine tilemaps can only reference 256 tiles, but the image has more unique tiles.\n");
+			tilemap[i] = index;
+		} else {
+			if (index > 0x3FF)
+				FATAL_ERROR("Tilemaps can only reference 1024 tiles, but the image has more unique tiles.\n");
+			uint16_t entry = index | ((flip & 1) << 10) | ((flip >> 1) << 11) | (palno << 12);
+			tilemap[i * 2] = entry & 0xFF;
+			tilemap[i * 2 + 1] = entry >> 8;
+		}
+
+		AdvanceMetatilePosition(&subTileX, &subTileY, &metatileX, &metatileY, metatilesWide, metatileWidth, metatileHeight);
+	}
+
+	WriteWholeFile(path, set.tiles, set.numTiles * tileSize);
+	WriteWholeFile(tilemapPath, tilemap, numTiles * mapEntrySize);
+
+	if (report) {
+		int savedBytes = (numTiles - set.numTiles) * tileSize;
+
+		printf("%s: %d tiles -> %d unique (%d matched flipped), saved %d bytes of VRAM (%d%%)\n",
+			path, numTiles, set.numTiles, numFlipped, savedBytes, numTiles ? savedBytes * 100 / (numTiles * tileSize) : 0);
+	}
+
+	free(tilemap);
+	free(set.hashTable);
+	free(set.tiles);
+}
+
 void FreeImage(struct Image *image)
 {
     if (image->tilemap.data.affine != NULL)
@@ -3,6 +3,7 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <time.h>
 #include "global.h"
 #include "huff.h"
 
@@ -184,6 +185,14 @@ static inline void write_32_le(unsigned char * dest, int * destPos, uint32_t * b
     *buffPos = 0;
 }
 
+static inline void put_32_le(unsigned char * dest, int * destPos, uint32_t value) {
+    dest[*destPos] = value;
+    dest[*destPos + 1] = value >> 8;
+    dest[*destPos + 2] = value >> 16;
+    dest[*destPos + 3] = value >> 24;
+    *destPos += 4;
+}
+
 static inline void read_32_le(unsigned char * src, int * srcPos, uint32_t * buff) {
     uint32_t tmp = src[*srcPos];
     tmp |= src[*srcPos + 1] << 8;
@@ -218,7 +227,11 @@ MAIN COMPRESSION/DECOMPRESSION ROUTINES
 =======================================
  */
 
-unsigned char * HuffCompress(unsigned char * src, int srcSize, int * compressedSize_p, int bitDepth) {
+/*
+ * The original encoder, kept as a reference for HuffCompress benchmarks.
+ * Builds an unrestricted Huffman tree and lays it out breadth-first.
+ */
+unsigned char * HuffCompressReference(unsigned char * src, int srcSize, int * compressedSize_p, int bitDepth) {
     if (srcSize <= 0)
         goto fail;
 
@@ -342,6 +355,335 @@ fail:
     FATAL_ERROR("Fatal error while compressing Huff file.\n");
 }
 
+/*
+=======================================
+LENGTH-LIMITED CANONICAL HUFFMAN CODING
+=======================================
+ */
+
+// Code lengths are limited so that two 4-bit codes (one source byte) or one
+// 8-bit code always fit in 32 bits, so the bit writer needs at most one
+// flush per source byte.
+#define HUFF_MAX_CODE_LENGTH 16
+
+// The BIOS stores the offset to a node's children in 6 bits, counted in
+// pairs of nodes, so children must be placed within 64 pairs of their parent.
+#define HUFF_MAX_CHILD_DISTANCE 64
+
+struct PackageItem {
+    uint64_t weight;
+    int symbol; // -1 for a package
+    int child;  // index of the first of the two packaged items in the previous level
+};
+
+static int cmp_package_leaf(const void * a0, const void * b0) {
+    const struct PackageItem * a = a0;
+    const struct PackageItem * b = b0;
+    if (a->weight != b->weight)
+        return a->weight < b->weight ? -1 : 1;
+    return a->symbol - b->symbol;
+}
+
+static void count_package_item(struct PackageItem ** levels, int level, int index, int * lengths) {
+    struct PackageItem * item = &levels[level][index];
+    if (item->symbol >= 0) {
+        lengths[item->symbol]++;
+    } else {
+        count_package_item(levels, level - 1, item->child, lengths);
+        count_package_item(levels, level - 1, item->child + 1, lengths);
+    }
+}
+
+/*
+ * Package-merge: computes optimal code lengths subject to a maximum length.
+ * symbols[] lists the nsymbols (>= 2) values to encode, lengths[] is indexed
+ * by value.
+ */
+static void build_code_lengths(const uint32_t * freqs, const int * symbols, int nsymbols, int maxLength, int * lengths) {
+    struct PackageItem * leaves = malloc(nsymbols * sizeof(struct PackageItem));
+    struct PackageItem ** levels = calloc(maxLength, sizeof(struct PackageItem *));
+    int * counts = calloc(maxLength, sizeof(int));
+    if (leaves == NULL || levels == NULL || counts == NULL)
+        FATAL_ERROR("Fatal error while compressing Huff file.\n");
+
+    for (int i = 0; i < nsymbols; i++) {
+        leaves[i].weight = freqs[symbols[i]];
+        leaves[i].symbol = symbols[i];
+        leaves[i].child = -1;
+    }
+    qsort(leaves, nsymbols, sizeof(struct PackageItem), cmp_package_leaf);
+
+    levels[0] = leaves;
+    counts[0] = nsymbols;
+
+    for (int level = 1; level < maxLength; level++) {
+        struct PackageItem * prev = levels[level - 1];
+        int npackages = counts[level - 1] / 2;
+        struct PackageItem * cur = malloc((nsymbols + npackages) * sizeof(struct PackageItem));
+        if (cur == NULL)
+            FATAL_ERROR("Fatal error while compressing Huff file.\n");
+
+        // Merge the leaves with the packages of the previous level, leaves first on ties.
+        int i = 0, j = 0, k = 0;
+        while (i < nsymbols || j < npackages) {
+            uint64_t packageWeight = j < npackages ? prev[j * 2].weight + prev[j * 2 + 1].weight : 0;
+            if (j >= npackages || (i < nsymbols && leaves[i].weight <= packageWeight)) {
+                cur[k++] = leaves[i++];
+            } else {
+                cur[k].weight = packageWeight;
+                cur[k].symbol = -1;
+                cur[k].child = j * 2;
+                k++;
+                j++;
+            }
+        }
+
+        levels[level] = cur;
+        counts[level] = k;
+    }
+
+    for (int i = 0; i < 2 * nsymbols - 2; i++)
+        count_package_item(levels, maxLength - 1, i, lengths);
+
+    for (int level = 1; level < maxLength; level++)
+        free(levels[level]);
+    free(levels);
+    free(counts);
+    free(leaves);
+}
+
+/*
+ * Canonical code assignment: shorter codes first, ties broken by value.
+ * symbols[] must be in value order on entry and is left in code order.
+ */
+static void build_canonical_codes(const int * lengths, int * symbols, int nsymbols, uint32_t * codes) {
+    // Stable insertion sort by length; symbols[] is already in value order.
+    for (int i = 1; i < nsymbols; i++) {
+        int sym = symbols[i];
+        int j = i - 1;
+        while (j >= 0 && lengths[symbols[j]] > lengths[sym]) {
+            symbols[j + 1] = symbols[j];
+            j--;
+        }
+        symbols[j + 1] = sym;
+    }
+
+    uint32_t code = 0;
+    int prevLength = lengths[symbols[0]];
+    for (int i = 0; i < nsymbols; i++) {
+        int sym = symbols[i];
+        code <<= lengths[sym] - prevLength;
+        codes[sym] = code++;
+        prevLength = lengths[sym];
+    }
+}
+
+struct TrieNode {
+    int child[2]; // 0 if absent
+    int symbol;   // -1 for branches
+    int branches; // number of branches in this subtree, including itself
+};
+
+struct PendingBranch {
+    int node;
+    int pos;      // position of the branch in the tree table
+    int deadline; // last pair slot its children may go in
+};
+
+/*
+ * Lays the code tree out in the BIOS format and returns the size of the tree
+ * table in bytes, including the size byte and padding up to a word.
+ *
+ * Branches are placed one pair slot at a time. Breadth-first order (what a
+ * plain queue gives) runs out of offset range on wide 8-bit trees, so instead
+ * each slot goes to the waiting branch with the smallest subtree, as long as
+ * every other waiting branch can still be placed in time. Finishing small
+ * subtrees first keeps the number of waiting branches low.
+ */
+static int write_canonical_tree(unsigned char * table, const int * lengths, const uint32_t * codes, const int * symbols, int nsymbols) {
+    int nnodes = 2 * nsymbols - 1;
+    struct TrieNode * trie = calloc(nnodes, sizeof(struct TrieNode));
+    struct PendingBranch * pending = malloc(nsymbols * sizeof(struct PendingBranch));
+    if (trie == NULL || pending == NULL)
+        FATAL_ERROR("Fatal error while compressing Huff file.\n");
+
+    int used = 1;
+    trie[0].symbol = -1;
+    for (int i = 0; i < nsymbols; i++) {
+        int sym = symbols[i];
+        int node = 0;
+        for (int bit = lengths[sym] - 1; bit >= 0; bit--) {
+            int dir = (codes[sym] >> bit) & 1;
+            if (trie[node].child[dir] == 0) {
+                if (used == nnodes)
+                    FATAL_ERROR("Fatal error while compressing Huff file: code is not prefix-free.\n");
+                trie[used].symbol = -1;
+                trie[node].child[dir] = used++;
+            }
+            node = trie[node].child[dir];
+        }
+        trie[node].symbol = sym;
+    }
+
+    // Children always come after their parent in the trie.
+    for (int i = nnodes - 1; i >= 0; i--) {
+        if (trie[i].symbol < 0)
+            trie[i].branches = 1 + trie[trie[i].child[0]].branches + trie[trie[i].child[1]].branches;
+    }
+
+    // Byte 0 is the size, byte 1 the root, and pair slot k is bytes 2k+2 and 2k+3.
+    int npending = 1;
+    pending[0].node = 0;
+    pending[0].pos = 1;
+    pending[0].deadline = HUFF_MAX_CHILD_DISTANCE - 1;
+
+    for (int slot = 0; npending > 0; slot++) {
+        // Sort by deadline so feasibility can be checked in one pass.
+        for (int i = 1; i < npending; i++) {
+            struct PendingBranch tmp = pending[i];
+            int j = i - 1;
+            while (j >= 0 && pending[j].deadline > tmp.deadline) {
+                pending[j + 1] = pending[j];
+                j--;
+            }
+            pending[j + 1] = tmp;
+        }
+
+        int best = -1;
+        for (int c = 0; c < npending; c++) {
+            if (pending[c].deadline < slot)
+                break;
+            if (best >= 0 && trie[pending[c].node].branches >= trie[pending[best].node].branches)
+                continue;
+            bool feasible = true;
+            for (int i = 0, s = slot + 1; feasible && i < npending; i++) {
+                if (i == c)
+                    continue;
+                if (pending[i].deadline < s++)
+                    feasible = false;
+            }
+            if (feasible)
+                best = c;
+        }
+        if (best < 0)
+            FATAL_ERROR("Fatal error while compressing Huff file: unable to encode binary tree.\n");
+
+        struct PendingBranch branch = pending[best];
+        pending[best] = pending[--npending];
+
+        int parentSlot = branch.pos >= 2 ? (branch.pos - 2) / 2 : -1;
+        table[branch.pos] = slot - parentSlot - 1;
+        for (int dir = 0; dir < 2; dir++) {
+            int child = trie[branch.node].child[dir];
+            int pos = slot * 2 + 2 + dir;
+            if (trie[child].symbol >= 0) {
+                table[pos] = trie[child].symbol;
+                table[branch.pos] |= 0x80 >> dir;
+            } else {
+                pending[npending].node = child;
+                pending[npending].pos = pos;
+                pending[npending].deadline = slot + HUFF_MAX_CHILD_DISTANCE;
+                npending++;
+            }
+        }
+    }
+
+    free(pending);
+    free(trie);
+
+    // Pad so the bitstream that follows the table starts on a word boundary.
+    int tableSize = (1 + nnodes + 3) & ~3;
+    table[0] = tableSize / 2 - 1;
+    return tableSize;
+}
+
+unsigned char * HuffCompress(unsigned char * src, int srcSize, int * compressedSize_p, int bitDepth) {
+    if (srcSize <= 0)
+        FATAL_ERROR("Fatal error while compressing Huff file.\n");
+
+    int nitems = 1 << bitDepth;
+    // The stream is decoded a word at a time, so encode a whole number of words.
+    int paddedSize = (srcSize + 3) & ~3;
+    uint32_t freqs[256] = {0};
+    int lengths[256] = {0};
+    uint32_t codes[256] = {0};
+    int symbols[256];
+    int nsymbols = 0;
+
+    for (int i = 0; i < srcSize; i++) {
+        if (bitDepth == 8) {
+            freqs[src[i]]++;
+        } else {
+            freqs[src[i] >> 4]++;
+            freqs[src[i] & 0xF]++;
+        }
+    }
+    freqs[0] += (paddedSize - srcSize) * (bitDepth == 8 ? 1 : 2);
+
+    for (int i = 0; i < nitems; i++) {
+        if (freqs[i] != 0)
+            symbols[nsymbols++] = i;
+    }
+
+    // The root must be a branch, so a single-valued input still gets a 1-bit code.
+    if (nsymbols == 1)
+        symbols[nsymbols++] = symbols[0] ^ 1;
+
+    build_code_lengths(freqs, symbols, nsymbols, HUFF_MAX_CODE_LENGTH, lengths);
+
+    // symbols[] is in value order here, which build_canonical_codes relies on
+    // for its tie-break.
+    if (symbols[0] > symbols[1]) {
+        int tmp = symbols[0];
+        symbols[0] = symbols[1];
+        symbols[1] = tmp;
+    }
+    build_canonical_codes(lengths, symbols, nsymbols, codes);
+
+    int worstCaseDestSize = 4 + 512 + paddedSize * 4;
+    unsigned char * dest = calloc(worstCaseDestSize, 1);
+    if (dest == NULL)
+        FATAL_ERROR("Fatal error while compressing Huff file.\n");
+
+    int destPos = 4 + write_canonical_tree(dest + 4, lengths, codes, symbols, nsymbols);
+
+    // Per-byte emission table. For 4-bit data the low nybble is coded first.
+    uint32_t byteCodes[256];
+    int byteLengths[256];
+    for (int i = 0; i < 256; i++) {
+        if (bitDepth == 8) {
+            byteCodes[i] = codes[i];
+            byteLengths[i] = lengths[i];
+        } else {
+            byteCodes[i] = (codes[i & 0xF] << lengths[i >> 4]) | codes[i >> 4];
+            byteLengths[i] = lengths[i & 0xF] + lengths[i >> 4];
+        }
+    }
+
+    // Bits are accumulated MSB-first and flushed as little-endian words.
+    uint64_t bitBuf = 0;
+    int bitCount = 0;
+    for (int i = 0; i < paddedSize; i++) {
+        unsigned char value = i < srcSize ? src[i] : 0;
+        bitBuf = (bitBuf << byteLengths[value]) | byteCodes[value];
+        bitCount += byteLengths[value];
+        if (bitCount >= 32) {
+            put_32_le(dest, &destPos, bitBuf >> (bitCount - 32));
+            bitCount -= 32;
+        }
+    }
+    if (bitCount != 0) {
+        put_32_le(dest, &destPos, bitBuf << (32 - bitCount));
+    }
+
+    dest[0] = bitDepth | 0x20;
+    dest[1] = srcSize;
+    dest[2] = srcSize >> 8;
+    dest[3] = srcSize >> 16;
+    *compressedSize_p = destPos;
+    return dest;
+}
+
 unsigned char * HuffDecompress(unsigned char * src, int srcSize, int * uncompressedSize_p) {
     if (srcSize < 4)
         goto fail;
@@ -396,3 +738,53 @@ unsigned char * HuffDecompress(unsigned char * src, int srcSize, int * uncompres
 fail:
     FATAL_ERROR("Fatal error while decompressing Huff file.\n");
 }
+
+/*
+ * Compares HuffCompress against the reference encoder on one input:
+ * compressed size and encoding throughput, plus a round trip through
+ * HuffDecompress.
+ */
+void HuffCompressBenchmark(const char * name, unsigned char * src, int srcSize, int bitDepth) {
+    typedef unsigned char * (*compressfun)(unsigned char *, int, int *, int);
+    static const compressfun encoders[] = { HuffCompressReference, HuffCompress };
+    static const char * const encoderNames[] = { "reference", "canonical" };
+
+    // The reference encoder reads whole words, so give it a padded copy.
+    unsigned char * padded = calloc((srcSize + 3) & ~3, 1);
+    if (padded == NULL)
+        FATAL_ERROR("Failed to allocate memory for benchmark.\n");
+    memcpy(padded, src, srcSize);
+
+    printf("%s (%d bytes, %d-bit):", name, srcSize, bitDepth);
+
+    for (int e = 0; e < 2; e++) {
+        int compressedSize = 0;
+        int iterations = 0;
+        clock_t start = clock();
+        clock_t elapsed;
+
+        do {
+            free(encoders[e](padded, srcSize, &compressedSize, bitDepth));
+            iterations++;
+            elapsed = clock() - start;
+        } while (elapsed < CLOCKS_PER_SEC / 10);
+
+        double seconds = (double)elapsed / CLOCKS_PER_SEC;
+        printf(" %s %d bytes (%.1f%%) %.1f MB/s;", encoderNames[e], compressedSize,
+            100.0 * compressedSize / srcSize, (double)srcSize * iterations / seconds / 1e6);
+    }
+
+    if (srcSize % 4 == 0) {
+        int compressedSize;
+        int uncompressedSize;
+        unsigned char * compressed = HuffCompress(padded, srcSize, &compressedSize, bitDepth);
+        unsigned char * uncompressed = HuffDecompress(compressed, compressedSize, &uncompressedSize);
+        printf(" round trip %s\n", uncompressedSize == srcSize && memcmp(uncompressed, src, srcSize) == 0 ? "ok" : "FAILED");
+        free(uncompressed);
+        free(compressed);
+    } else {
+        printf(" round trip skipped\n");
+    }
+
+    free(padded);
+}
@@ -33,6 +33,8 @@ struct BitEncoding {
 };
 
 unsigned char * HuffCompress(unsigned char * buffer, int srcSize, int * compressedSize_p, int bitDepth);
+unsigned char * HuffCompressReference(unsigned char * buffer, int srcSize, int * compressedSize_p, int bitDepth);
 unsigned char * HuffDecompress(unsigned char * buffer, int srcSize, int * uncompressedSize_p);
+void HuffCompressBenchmark(const char * name, unsigned char * src, int srcSize, int bitDepth);
 
 #endif //HUFF_H
@@ -75,9 +75,28 @@ void ConvertPngToGba(char *inputPath, char *outputPath, struct PngToGbaOptions *
     image.bitDepth = options->bitDepth;
     image.tilemap.data.affine = NULL; // initialize to NULL to avoid issues in FreeImage
 
-    ReadPng(inputPath, &image);
+    if (options->tilemapFilePath != NULL)
+    {
+        bool bankedPalette = false;
+
+        // Read one pixel per byte so the palette bank of each tile is kept.
+        image.bitDepth = 8;
+        ReadPng(inputPath, &image);
 
-    WriteImage(outputPath, options->numTiles, options->bitDepth, options->metatileWidth, options->metatileHeight, &image, !image.hasPalette);
+        if (image.hasPalette)
+        {
+            ReadPngPalette(inputPath, &image.palette);
+            bankedPalette = options->bitDepth == 4 && image.palette.numColors > 16;
+        }
+
+        WriteTilemapImage(outputPath, options->tilemapFilePath, options->bitDepth, options->metatileWidth, options->metatileHeight, &image, !image.hasPalette, options->isAffineMap, bankedPalette, options->report);
+    }
+    else
+    {
+        ReadPng(inputPath, &image);
+
+        WriteImage(outputPath, options->numTiles, options->bitDepth, options->metatileWidth, options->metatileHeight, &image, !image.hasPalette);
+    }
 
     FreeImage(&image);
 }
@@ -185,6 +204,7 @@ void HandlePngToGbaCommand(char *inputPath, char *outputPath, int argc, char **a
     options.metatileHeight = 1;
     options.tilemapFilePath = NULL;
     options.isAffineMap = false;
+    options.report = false;
 
     for (int i = 3; i < argc; i++)
     {
@@ -229,12 +249,33 @@ void HandlePngToGbaCommand(char *inputPath, char *outputPath, int argc, char **a
             if (options.metatileHeight < 1)
                 FATAL_ERROR("metatile height must be positive.\n");
         }
+        else if (strcmp(option, "-tilemap") == 0)
+        {
+            if (i + 1 >= argc)
+                FATAL_ERROR("No tilemap value following \"-tilemap\".\n");
+            i++;
+            options.tilemapFilePath = argv[i];
+        }
+        else if (strcmp(option, "-affine") == 0)
+        {
+            options.isAffineMap = true;
+        }
+        else if (strcmp(option, "-report") == 0)
+        {
+            options.report = true;
+        }
         else
         {
             FATAL_ERROR("Unrecognized option \"%s\".\n", option);
         }
     }
 
+    if (options.tilemapFilePath != NULL && options.numTiles != 0)
+        FATAL_ERROR("\"-num_tiles\" can't be used together with \"-tilemap\".\n");
+
+    if (options.tilemapFilePath == NULL && (options.isAffineMap || options.report))
+        FATAL_ERROR("\"-affine\" and \"-report\" require \"-tilemap\".\n");
+
     ConvertPngToGba(inputPath, outputPath, &options);
 }
 
@@ -484,6 +525,7 @@ void HandleHuffCompressCommand(char *inputPath, char *outputPath, int argc, char
 {
     int fileSize;
     int bitDepth = 4;
+    bool benchmark = false;
 
     for (int i = 3; i < argc; i++)
     {
@@ -502,6 +544,10 @@ void HandleHuffCompressCommand(char *inputPath, char *outputPath, int argc, char
             if (bitDepth != 4 && bitDepth != 8)
                 FATAL_ERROR("GBA only supports bit depth of 4 or 8.\n");
         }
+        else if (strcmp(option, "-bench") == 0)
+        {
+            benchmark = true;
+        }
         else
         {
             FATAL_ERROR("Unrecognized option \"%s\".\n", option);
@@ -510,6 +556,9 @@ void HandleHuffCompressCommand(char *inputPath, char *outputPath, int argc, char
 
     unsigned char *buffer = ReadWholeFile(inputPath, &fileSize);
 
+    if (benchmark)
+        HuffCompressBenchmark(inputPath, buffer, fileSize, bitDepth);
+
     int compressedSize;
     unsigned char *compressedData = HuffCompress(buffer, fileSize, &compressedSize, bitDepth);
 
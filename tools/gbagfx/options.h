@@ -23,6 +23,7 @@ struct PngToGbaOptions {
     int metatileHeight;
     char *tilemapFilePath;
     bool isAffineMap;
+    bool report;
 };
 
 #endif // OPTIONS_H
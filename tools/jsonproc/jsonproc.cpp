@@ -3,6 +3,12 @@
 #include "jsonproc.h"
 
 #include <map>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <mutex>
 
 #include <string>
 using std::string; using std::to_string;
@@ -11,32 +17,33 @@ using std::string; using std::to_string;
 using namespace inja;
 using json = nlohmann::json;
 
-std::map<string, string> customVars;
+// State that belongs to a single render. Callbacks are registered once per
+// environment, so they find the render they are running for through this
+// thread-local pointer.
+struct RenderContext
+{
+    string jsonFilepath;
+    string templateFilepath;
+    std::map<string, string> customVars;
+};
+
+static thread_local RenderContext *currentContext;
 
 void set_custom_var(string key, string value)
 {
-    customVars[key] = value;
+    currentContext->customVars[key] = value;
 }
 
 string get_custom_var(string key)
 {
-    return customVars[key];
+    return currentContext->customVars[key];
 }
 
-int main(int argc, char *argv[])
+static void add_callbacks(Environment& env)
 {
-    if (argc != 4)
-        FATAL_ERROR("USAGE: jsonproc <json-filepath> <template-filepath> <output-filepath>\n");
-
-    string jsonfilepath = argv[1];
-    string templateFilepath = argv[2];
-    string outputFilepath = argv[3];
-
-    Environment env;
-
     // Add custom command callbacks.
-    env.add_callback("doNotModifyHeader", 0, [jsonfilepath, templateFilepath](Arguments& args) {
-        return "//\n// DO NOT MODIFY THIS FILE! It is auto-generated from " + jsonfilepath +" and Inja template " + templateFilepath + "\n//\n";
+    env.add_callback("doNotModifyHeader", 0, [](Arguments& args) {
+        return "//\n// DO NOT MODIFY THIS FILE! It is auto-generated from " + currentContext->jsonFilepath +" and Inja template " + currentContext->templateFilepath + "\n//\n";
     });
 
     env.add_callback("subtract", 2, [](Arguments& args) {
@@ -95,10 +102,187 @@ int main(int argc, char *argv[])
     env.add_callback("isEmpty", 1, [](Arguments& args) {
         return args.at(0)->empty();
     });
+}
+
+// Writes the output only if its contents changed, so that anything depending
+// on it isn't rebuilt needlessly. Returns whether the file was written.
+static bool write_if_changed(const string& filepath, const string& contents)
+{
+    std::ifstream existing(filepath, std::ios::binary);
+    if (existing)
+    {
+        std::ostringstream current;
+        current << existing.rdbuf();
+        if (current.str() == contents)
+            return false;
+    }
+    existing.close();
+
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Failed to open " + filepath + " for writing");
+    file << contents;
+    return true;
+}
+
+struct ManifestEntry
+{
+    string jsonFilepath;
+    string templateFilepath;
+    string outputFilepath;
+    size_t jsonIndex;
+    size_t templateIndex;
+};
+
+// Runs job(i) for every i in [0, count) across the given number of threads.
+// The first error is kept and reported once all threads have finished.
+template <typename Job>
+static void run_parallel(size_t count, unsigned int numThreads, Job job)
+{
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+    string error;
+    std::mutex errorMutex;
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < count && !failed; i = next++)
+        {
+            try
+            {
+                job(i);
+            }
+            catch (const std::exception& e)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!failed.exchange(true))
+                    error = e.what();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < numThreads && i < count; i++)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread& thread : threads)
+        thread.join();
+
+    if (failed)
+        FATAL_ERROR("JSONPROC_ERROR: %s\n", error.c_str());
+}
+
+// Manifest mode: each non-empty line of the manifest that doesn't start with
+// '#' is a "<json-filepath> <template-filepath> <output-filepath>" triple.
+// Every distinct JSON and template file is parsed once, and the outputs are
+// rendered in parallel.
+static void process_manifest(const string& manifestFilepath, unsigned int numThreads)
+{
+    std::ifstream manifest(manifestFilepath);
+    if (!manifest)
+        FATAL_ERROR("Failed to open manifest %s\n", manifestFilepath.c_str());
+
+    std::vector<ManifestEntry> entries;
+    std::vector<string> jsonFilepaths;
+    std::vector<string> templateFilepaths;
+    std::map<string, size_t> jsonIndices;
+    std::map<string, size_t> templateIndices;
+    string line;
+    int lineNum = 0;
+
+    while (std::getline(manifest, line))
+    {
+        lineNum++;
+
+        std::istringstream fields(line);
+        ManifestEntry entry;
+        if (!(fields >> entry.jsonFilepath) || entry.jsonFilepath[0] == '#')
+            continue;
+        if (!(fields >> entry.templateFilepath >> entry.outputFilepath))
+            FATAL_ERROR("%s:%d: expected <json-filepath> <template-filepath> <output-filepath>\n", manifestFilepath.c_str(), lineNum);
+
+        auto jsonSlot = jsonIndices.emplace(entry.jsonFilepath, jsonFilepaths.size());
+        if (jsonSlot.second)
+            jsonFilepaths.push_back(entry.jsonFilepath);
+        entry.jsonIndex = jsonSlot.first->second;
+
+        auto tmpl = templateIndices.emplace(entry.templateFilepath, templateFilepaths.size());
+        if (tmpl.second)
+            templateFilepaths.push_back(entry.templateFilepath);
+        entry.templateIndex = tmpl.first->second;
+
+        entries.push_back(entry);
+    }
+
+    Environment env;
+    add_callbacks(env);
+
+    // Parsing can register included templates with the environment, so it
+    // stays on one thread. Rendering only reads from the environment.
+    std::vector<Template> templates;
+    try
+    {
+        for (const string& filepath : templateFilepaths)
+            templates.push_back(env.parse_template(filepath));
+    }
+    catch (const std::exception& e)
+    {
+        FATAL_ERROR("JSONPROC_ERROR: %s\n", e.what());
+    }
+
+    std::vector<json> jsons(jsonFilepaths.size());
+    run_parallel(jsons.size(), numThreads, [&](size_t i) {
+        jsons[i] = env.load_json(jsonFilepaths[i]);
+    });
+
+    std::atomic<int> numWritten(0);
+    run_parallel(entries.size(), numThreads, [&](size_t i) {
+        const ManifestEntry& entry = entries[i];
+        RenderContext context;
+        context.jsonFilepath = entry.jsonFilepath;
+        context.templateFilepath = entry.templateFilepath;
+        currentContext = &context;
+
+        string output = env.render(templates[entry.templateIndex], jsons[entry.jsonIndex]);
+        currentContext = nullptr;
+
+        if (write_if_changed(entry.outputFilepath, output))
+            numWritten++;
+    });
+
+    printf("jsonproc: rendered %d outputs, %d changed\n", (int)entries.size(), numWritten.load());
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 3 && string(argv[1]) == "-manifest")
+    {
+        unsigned int numThreads = std::thread::hardware_concurrency();
+
+        if (argc == 5 && string(argv[3]) == "-j")
+            numThreads = std::atoi(argv[4]);
+        else if (argc != 3)
+            FATAL_ERROR("USAGE: jsonproc -manifest <manifest-filepath> [-j <threads>]\n");
+
+        process_manifest(argv[2], numThreads > 0 ? numThreads : 1);
+        return 0;
+    }
+
+    if (argc != 4)
+        FATAL_ERROR("USAGE: jsonproc <json-filepath> <template-filepath> <output-filepath>\n"
+                    "       jsonproc -manifest <manifest-filepath> [-j <threads>]\n");
+
+    RenderContext context;
+    context.jsonFilepath = argv[1];
+    context.templateFilepath = argv[2];
+    string outputFilepath = argv[3];
+    currentContext = &context;
+
+    Environment env;
+    add_callbacks(env);
 
     try
     {
-        env.write_with_json_file(templateFilepath, jsonfilepath, outputFilepath);
+        env.write_with_json_file(context.templateFilepath, context.jsonFilepath, outputFilepath);
     }
     catch (const std::exception& e)
     {
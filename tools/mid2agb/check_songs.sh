@@ -0,0 +1,63 @@
+#!/bin/sh
+# Converts every song in songs.mk with and without compression and checks
+# with seqcheck that the compressed tracks play the same command stream.
+#
+# usage: check_songs.sh songs.mk midi_dir
+
+set -e
+
+if [ $# -ne 2 ]; then
+    echo "usage: $0 songs.mk midi_dir" >&2
+    exit 2
+fi
+
+tooldir=$(cd "$(dirname "$0")" && pwd)
+songs_mk=$1
+midi_dir=$2
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+mkdir "$work/ref" "$work/out"
+
+# Each song's rule in songs.mk is its target line followed by the mid2agb
+# command with the song's options.
+std_reverb=$(sed -n 's/^STD_REVERB *= *//p' "$songs_mk")
+
+awk -v midi="$midi_dir" -v work="$work" -v reverb="$std_reverb" '
+/^\$\(MID_SUBDIR\)\/.*\.s: %\.s: %\.mid/ {
+    song = $1
+    sub(/^\$\(MID_SUBDIR\)\//, "", song)
+    sub(/\.s:$/, "", song)
+    next
+}
+song != "" && /^\t\$\(MID\)/ {
+    options = $0
+    sub(/^\t\$\(MID\) \$< \$@ */, "", options)
+    gsub(/\$\(STD_REVERB\)/, reverb, options)
+    print midi "/" song ".mid " work "/out/" song ".s " options > (work "/out.list")
+    print midi "/" song ".mid " work "/ref/" song ".s " options " -N" > (work "/ref.list")
+    song = ""
+}' "$songs_mk"
+
+"$tooldir/mid2agb" -B "$work/ref.list"
+"$tooldir/mid2agb" -B "$work/out.list"
+
+total=0
+failed=0
+patterned=0
+
+for ref in "$work"/ref/*.s; do
+    song=$(basename "$ref")
+    total=$((total + 1))
+
+    if ! "$tooldir/seqcheck" "$ref" "$work/out/$song"; then
+        failed=$((failed + 1))
+    fi
+
+    if grep -q PATT "$work/out/$song"; then
+        patterned=$((patterned + 1))
+    fi
+done
+
+echo "$total songs checked, $patterned use patterns, $failed differ"
+[ "$failed" -eq 0 ]
@@ -19,10 +19,11 @@
 // THE SOFTWARE.
 
 #include <cstdio>
-#include <cstdlib>
 #include <cstdarg>
+#include <stdexcept>
 
-// Reports an error diagnostic and terminates the program.
+// Reports an error diagnostic by throwing it, so that in batch mode the
+// error can be tied to the song that caused it.
 [[noreturn]] void RaiseError(const char* format, ...)
 {
     const int bufferSize = 1024;
@@ -30,7 +31,6 @@
     std::va_list args;
     va_start(args, format);
     std::vsnprintf(buffer, bufferSize, format, args);
-    std::fprintf(stderr, "error: %s\n", buffer);
     va_end(args);
-    std::exit(1);
+    throw std::runtime_error(buffer);
 }
@@ -23,29 +23,38 @@
 #include <cstring>
 #include <cctype>
 #include <cassert>
+#include <cinttypes>
 #include <string>
-#include <set>
-#include "main.h"
+#include <vector>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
 #include "error.h"
-#include "midi.h"
-#include "agb.h"
+#include "song.h"
 
-FILE* g_inputFile = nullptr;
-FILE* g_outputFile = nullptr;
+struct SongJob
+{
+    std::string inputFilename;
+    std::string outputFilename;
+    SongOptions options;
+};
+
+struct BatchOptions
+{
+    std::string listFilename;
+    unsigned threadCount = 0;
+};
 
-std::string g_asmLabel;
-int g_masterVolume = 127;
-int g_voiceGroup = 0;
-int g_priority = 0;
-int g_reverb = -1;
-int g_clocksPerBeat = 1;
-bool g_exactGateTime = false;
-bool g_compressionEnabled = true;
+// Bump this whenever the generated assembly changes, so that batch mode
+// doesn't keep outputs made by an older version of the converter.
+static const char* s_cacheVersion = "1";
 
 [[noreturn]] static void PrintUsage()
 {
     std::printf(
         "Usage: MID2AGB name [options]\n"
+        "       MID2AGB -B list [-J threads] [options]\n"
         "\n"
         "    input_file  filename(.mid) of MIDI file\n"
         "   output_file  filename(.s) for AGB file (default:input_file)\n"
@@ -58,6 +67,11 @@ bool g_compressionEnabled = true;
         "            -X  48 clocks/beat (default:24 clocks/beat)\n"
         "            -E  exact gate-time\n"
         "            -N  no compression\n"
+        "\n"
+        "batch    -B???  convert every song in list file ???, one\n"
+        "                \"input_file [output_file] [options]\" per line\n"
+        "                (options given with -B apply to every song)\n"
+        "         -J???  number of threads (default:all cores)\n"
     );
     std::exit(1);
 }
@@ -102,24 +116,23 @@ static std::string BaseName(std::string s)
     return s;
 }
 
-static const char *GetArgument(int argc, char **argv, int& index)
+static const char *GetArgument(const std::vector<std::string>& args, std::size_t& index)
 {
-    assert(index >= 0 && index < argc);
+    assert(index < args.size());
 
-    const char *option = argv[index];
+    const std::string& option = args[index];
 
-    assert(option != nullptr);
     assert(option[0] == '-');
 
     // If there is text following the letter, return that.
-    if (std::strlen(option) >= 3)
-        return option + 2;
+    if (option.size() >= 3)
+        return option.c_str() + 2;
 
     // Otherwise, try to get the next arg.
-    if (index + 1 < argc)
+    if (index + 1 < args.size())
     {
         index++;
-        return argv[index];
+        return args[index].c_str();
     }
     else
     {
@@ -127,14 +140,13 @@ static const char *GetArgument(int argc, char **argv, int& index)
     }
 }
 
-int main(int argc, char** argv)
+// Parses the arguments for one song into job. Batch options are only
+// accepted when batch is non-null. Returns false if the arguments are invalid.
+static bool ParseArguments(const std::vector<std::string>& args, SongJob& job, BatchOptions* batch)
 {
-    std::string inputFilename;
-    std::string outputFilename;
-
-    for (int i = 1; i < argc; i++)
+    for (std::size_t i = 0; i < args.size(); i++)
     {
-        const char *option = argv[i];
+        const char *option = args[i].c_str();
 
         if (option[0] == '-' && option[1] != '\0')
         {
@@ -142,92 +154,351 @@ int main(int argc, char** argv)
 
             switch (std::toupper(option[1]))
             {
+            case 'B':
+                arg = GetArgument(args, i);
+                if (arg == nullptr || batch == nullptr)
+                    return false;
+                batch->listFilename = arg;
+                break;
             case 'E':
-                g_exactGateTime = true;
+                job.options.exactGateTime = true;
                 break;
             case 'G':
-                arg = GetArgument(argc, argv, i);
+                arg = GetArgument(args, i);
                 if (arg == nullptr)
-                    PrintUsage();
-                g_voiceGroup = std::stoi(arg);
+                    return false;
+                job.options.voiceGroup = std::stoi(arg);
+                break;
+            case 'J':
+                arg = GetArgument(args, i);
+                if (arg == nullptr || batch == nullptr)
+                    return false;
+                batch->threadCount = std::stoi(arg);
                 break;
             case 'L':
-                arg = GetArgument(argc, argv, i);
+                arg = GetArgument(args, i);
                 if (arg == nullptr)
-                    PrintUsage();
-                g_asmLabel = arg;
+                    return false;
+                job.options.asmLabel = arg;
                 break;
             case 'N':
-                g_compressionEnabled = false;
+                job.options.compressionEnabled = false;
                 break;
             case 'P':
-                arg = GetArgument(argc, argv, i);
+                arg = GetArgument(args, i);
                 if (arg == nullptr)
-                    PrintUsage();
-                g_priority = std::stoi(arg);
+                    return false;
+                job.options.priority = std::stoi(arg);
                 break;
             case 'R':
-                arg = GetArgument(argc, argv, i);
+                arg = GetArgument(args, i);
                 if (arg == nullptr)
-                    PrintUsage();
-                g_reverb = std::stoi(arg);
+                    return false;
+                job.options.reverb = std::stoi(arg);
                 break;
             case 'V':
-                arg = GetArgument(argc, argv, i);
+                arg = GetArgument(args, i);
                 if (arg == nullptr)
-                    PrintUsage();
-                g_masterVolume = std::stoi(arg);
+                    return false;
+                job.options.masterVolume = std::stoi(arg);
                 break;
             case 'X':
-                g_clocksPerBeat = 2;
+                job.options.clocksPerBeat = 2;
                 break;
             default:
-                PrintUsage();
+                return false;
             }
         }
         else
         {
-            if (inputFilename.empty())
-                inputFilename = argv[i];
-            else if (outputFilename.empty())
-                outputFilename = argv[i];
+            if (job.inputFilename.empty())
+                job.inputFilename = option;
+            else if (job.outputFilename.empty())
+                job.outputFilename = option;
             else
-                PrintUsage();
+                return false;
         }
     }
 
-    if (inputFilename.empty())
-        PrintUsage();
+    return true;
+}
 
-    if (GetExtension(inputFilename) != "mid")
+// Checks the filenames of a parsed song and fills in the defaults.
+static void FinishSongJob(SongJob& job)
+{
+    if (GetExtension(job.inputFilename) != "mid")
         RaiseError("input filename extension is not \"mid\"");
 
-    if (outputFilename.empty())
-        outputFilename = StripExtension(inputFilename) + ".s";
+    if (job.outputFilename.empty())
+        job.outputFilename = StripExtension(job.inputFilename) + ".s";
 
-    if (GetExtension(outputFilename) != "s")
+    if (GetExtension(job.outputFilename) != "s")
         RaiseError("output filename extension is not \"s\"");
 
-    if (g_asmLabel.empty())
-        g_asmLabel = BaseName(outputFilename);
+    if (job.options.asmLabel.empty())
+        job.options.asmLabel = BaseName(job.outputFilename);
+}
+
+static std::vector<std::uint8_t> ReadFileData(const std::string& filename)
+{
+    FILE* file = std::fopen(filename.c_str(), "rb");
+
+    if (file == nullptr)
+        RaiseError("failed to open \"%s\" for reading", filename.c_str());
+
+    std::vector<std::uint8_t> data;
+    std::uint8_t buffer[0x4000];
+    std::size_t count;
+
+    while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+        data.insert(data.end(), buffer, buffer + count);
+
+    std::fclose(file);
+
+    return data;
+}
+
+static void WriteOutput(const std::string& filename, const std::string& output)
+{
+    FILE* file = std::fopen(filename.c_str(), "w");
+
+    if (file == nullptr)
+        RaiseError("failed to open \"%s\" for writing", filename.c_str());
+
+    if (std::fwrite(output.data(), 1, output.size(), file) != output.size())
+        RaiseError("failed to write \"%s\"", filename.c_str());
+
+    std::fclose(file);
+}
+
+// FNV-1a
+static std::uint64_t HashData(std::uint64_t hash, const void* data, std::size_t size)
+{
+    const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+
+    for (std::size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ULL;
+    }
+
+    return hash;
+}
+
+// Hashes everything that affects the output of a song: the MIDI data and
+// the settings it is converted with.
+static std::uint64_t HashSong(const SongJob& job, const std::vector<std::uint8_t>& midiData)
+{
+    const SongOptions& options = job.options;
+    char settings[64];
+    std::snprintf(settings, sizeof(settings), "%s %d %d %d %d %d %d %d",
+        s_cacheVersion, options.masterVolume, options.voiceGroup, options.priority, options.reverb,
+        options.clocksPerBeat, options.exactGateTime, options.compressionEnabled);
+
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    hash = HashData(hash, settings, std::strlen(settings) + 1);
+    hash = HashData(hash, job.inputFilename.c_str(), job.inputFilename.size() + 1);
+    hash = HashData(hash, options.asmLabel.c_str(), options.asmLabel.size() + 1);
+    hash = HashData(hash, midiData.data(), midiData.size());
+    return hash;
+}
+
+// The cache records the hash of each output's song as "<hash> <output_file>"
+// lines, so that unchanged songs can be skipped without converting them.
+static std::map<std::string, std::uint64_t> ReadCache(const std::string& filename)
+{
+    std::map<std::string, std::uint64_t> cache;
+    FILE* file = std::fopen(filename.c_str(), "r");
+
+    if (file == nullptr)
+        return cache;
+
+    char line[1024];
+
+    while (std::fgets(line, sizeof(line), file) != nullptr)
+    {
+        std::uint64_t hash;
+        char outputFilename[1024];
+
+        if (std::sscanf(line, "%" SCNx64 " %1023s", &hash, outputFilename) == 2)
+            cache[outputFilename] = hash;
+    }
+
+    std::fclose(file);
+
+    return cache;
+}
+
+static void WriteCache(const std::string& filename, const std::map<std::string, std::uint64_t>& cache)
+{
+    std::string output;
+
+    for (const auto& entry : cache)
+    {
+        char hash[32];
+        std::snprintf(hash, sizeof(hash), "%016" PRIx64 " ", entry.second);
+        output += hash + entry.first + "\n";
+    }
+
+    WriteOutput(filename, output);
+}
+
+static bool FileExists(const std::string& filename)
+{
+    FILE* file = std::fopen(filename.c_str(), "rb");
+
+    if (file == nullptr)
+        return false;
+
+    std::fclose(file);
+    return true;
+}
+
+// Converts every song in the list across several threads, skipping songs
+// whose hash matches the one recorded when their output was last written.
+static int ConvertBatch(const BatchOptions& batch, const SongJob& defaults)
+{
+    std::vector<SongJob> jobs;
+    FILE* listFile = std::fopen(batch.listFilename.c_str(), "r");
+
+    if (listFile == nullptr)
+        RaiseError("failed to open \"%s\" for reading", batch.listFilename.c_str());
+
+    char line[1024];
+    int lineNum = 0;
 
-    g_inputFile = std::fopen(inputFilename.c_str(), "rb");
+    while (std::fgets(line, sizeof(line), listFile) != nullptr)
+    {
+        lineNum++;
+
+        std::vector<std::string> args;
+        char* saveptr = line;
+        char* token;
+
+        while ((token = std::strtok(saveptr, " \t\r\n")) != nullptr)
+        {
+            saveptr = nullptr;
+            args.push_back(token);
+        }
+
+        if (args.empty() || args[0][0] == '#')
+            continue;
 
-    if (g_inputFile == nullptr)
-        RaiseError("failed to open \"%s\" for reading", inputFilename.c_str());
+        SongJob job = defaults;
 
-    g_outputFile = std::fopen(outputFilename.c_str(), "w");
+        if (!ParseArguments(args, job, nullptr) || job.inputFilename.empty())
+        {
+            std::fclose(listFile);
+            RaiseError("%s:%d: invalid song arguments", batch.listFilename.c_str(), lineNum);
+        }
+
+        FinishSongJob(job);
+        jobs.push_back(job);
+    }
+
+    std::fclose(listFile);
+
+    std::string cacheFilename = batch.listFilename + ".cache";
+    std::map<std::string, std::uint64_t> cache = ReadCache(cacheFilename);
+
+    std::vector<std::uint64_t> hashes(jobs.size());
+    std::vector<char> converted(jobs.size(), false);
+    std::vector<std::string> errors(jobs.size());
+    std::atomic<std::size_t> nextJob(0);
+
+    auto worker = [&]() {
+        for (std::size_t i = nextJob++; i < jobs.size(); i = nextJob++)
+        {
+            const SongJob& job = jobs[i];
+
+            try
+            {
+                std::vector<std::uint8_t> midiData = ReadFileData(job.inputFilename);
+                hashes[i] = HashSong(job, midiData);
+
+                auto cached = cache.find(job.outputFilename);
+                if (cached != cache.end() && cached->second == hashes[i] && FileExists(job.outputFilename))
+                    continue;
+
+                Song song(job.options, std::move(midiData));
+                WriteOutput(job.outputFilename, song.Convert());
+                converted[i] = true;
+            }
+            catch (const std::exception& e)
+            {
+                errors[i] = e.what();
+            }
+        }
+    };
 
-    if (g_outputFile == nullptr)
-        RaiseError("failed to open \"%s\" for writing", outputFilename.c_str());
+    unsigned threadCount = batch.threadCount ? batch.threadCount : std::thread::hardware_concurrency();
+    std::vector<std::thread> threads;
 
-    ReadMidiFileHeader();
-    PrintAgbHeader();
-    ReadMidiTracks();
-    PrintAgbFooter();
+    for (unsigned i = 1; i < threadCount && i < jobs.size(); i++)
+        threads.emplace_back(worker);
 
-    std::fclose(g_inputFile);
-    std::fclose(g_outputFile);
+    worker();
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    int convertedCount = 0;
+    int errorCount = 0;
+
+    for (std::size_t i = 0; i < jobs.size(); i++)
+    {
+        if (!errors[i].empty())
+        {
+            std::fprintf(stderr, "error: %s: %s\n", jobs[i].inputFilename.c_str(), errors[i].c_str());
+            cache.erase(jobs[i].outputFilename);
+            errorCount++;
+        }
+        else if (converted[i])
+        {
+            cache[jobs[i].outputFilename] = hashes[i];
+            convertedCount++;
+        }
+    }
+
+    WriteCache(cacheFilename, cache);
+
+    std::printf("mid2agb: converted %d songs, %d up to date\n", convertedCount, (int)jobs.size() - convertedCount - errorCount);
+
+    return errorCount > 0 ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> args(argv + 1, argv + argc);
+    SongJob job;
+    BatchOptions batch;
+
+    if (!ParseArguments(args, job, &batch))
+        PrintUsage();
+
+    try
+    {
+        if (!batch.listFilename.empty())
+        {
+            if (!job.inputFilename.empty())
+                PrintUsage();
+
+            return ConvertBatch(batch, job);
+        }
+
+        if (job.inputFilename.empty())
+            PrintUsage();
+
+        FinishSongJob(job);
+
+        Song song(job.options, ReadFileData(job.inputFilename));
+        WriteOutput(job.outputFilename, song.Convert());
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "error: %s\n", e.what());
+        return 1;
+    }
 
     return 0;
 }
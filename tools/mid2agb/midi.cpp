@@ -25,68 +25,45 @@
 #include <algorithm>
 #include <memory>
 #include "midi.h"
-#include "main.h"
+#include "song.h"
 #include "error.h"
-#include "agb.h"
 #include "tables.h"
 
-enum class MidiEventCategory
+void Song::Seek(long offset)
 {
-    Control,
-    SysEx,
-    Meta,
-    Invalid,
-};
+    if (offset < 0 || offset > (long)m_midiData.size())
+        RaiseError("failed to seek to %ld", offset);
 
-MidiFormat g_midiFormat;
-std::int_fast32_t g_midiTrackCount;
-std::int16_t g_midiTimeDiv;
-
-int g_midiChan;
-std::int32_t g_initialWait;
-
-static long s_trackDataStart;
-static std::vector<Event> s_seqEvents;
-static std::vector<Event> s_trackEvents;
-static std::int32_t s_absoluteTime;
-static int s_blockCount = 0;
-static int s_minNote;
-static int s_maxNote;
-static int s_runningStatus;
-
-void Seek(long offset)
-{
-    if (std::fseek(g_inputFile, offset, SEEK_SET) != 0)
-        RaiseError("failed to seek to %l", offset);
+    m_midiPos = offset;
 }
 
-void Skip(long offset)
+void Song::Skip(long offset)
 {
-    if (std::fseek(g_inputFile, offset, SEEK_CUR) != 0)
-        RaiseError("failed to skip %l bytes", offset);
+    if (offset < 0 || offset > (long)m_midiData.size() - m_midiPos)
+        RaiseError("failed to skip %ld bytes", offset);
+
+    m_midiPos += offset;
 }
 
-std::string ReadSignature()
+std::string Song::ReadSignature()
 {
-    char signature[4];
-
-    if (std::fread(signature, 4, 1, g_inputFile) != 1)
+    if (m_midiPos + 4 > (long)m_midiData.size())
         RaiseError("failed to read signature");
 
-    return std::string(signature, 4);
+    std::string signature((const char*)&m_midiData[m_midiPos], 4);
+    m_midiPos += 4;
+    return signature;
 }
 
-std::uint32_t ReadInt8()
+std::uint32_t Song::ReadInt8()
 {
-    int c = std::fgetc(g_inputFile);
-
-    if (c < 0)
+    if (m_midiPos >= (long)m_midiData.size())
         RaiseError("unexpected EOF");
 
-    return c;
+    return m_midiData[m_midiPos++];
 }
 
-std::uint32_t ReadInt16()
+std::uint32_t Song::ReadInt16()
 {
     std::uint32_t val = 0;
     val |= ReadInt8() << 8;
@@ -94,7 +71,7 @@ std::uint32_t ReadInt16()
     return val;
 }
 
-std::uint32_t ReadInt24()
+std::uint32_t Song::ReadInt24()
 {
     std::uint32_t val = 0;
     val |= ReadInt8() << 16;
@@ -103,7 +80,7 @@ std::uint32_t ReadInt24()
     return val;
 }
 
-std::uint32_t ReadInt32()
+std::uint32_t Song::ReadInt32()
 {
     std::uint32_t val = 0;
     val |= ReadInt8() << 24;
@@ -113,7 +90,7 @@ std::uint32_t ReadInt32()
     return val;
 }
 
-std::uint32_t ReadVLQ()
+std::uint32_t Song::ReadVLQ()
 {
     std::uint32_t val = 0;
     std::uint32_t c;
@@ -128,7 +105,7 @@ std::uint32_t ReadVLQ()
     return val;
 }
 
-void ReadMidiFileHeader()
+void Song::ReadMidiFileHeader()
 {
     Seek(0);
 
@@ -145,15 +122,15 @@ void ReadMidiFileHeader()
     if (midiFormat >= 2)
         RaiseError("unsupported MIDI format (%u)", midiFormat);
 
-    g_midiFormat = (MidiFormat)midiFormat;
-    g_midiTrackCount = ReadInt16();
-    g_midiTimeDiv = ReadInt16();
+    m_midiFormat = (MidiFormat)midiFormat;
+    m_midiTrackCount = ReadInt16();
+    m_midiTimeDiv = ReadInt16();
 
-    if (g_midiTimeDiv < 0)
-        RaiseError("unsupported MIDI time division (%d)", g_midiTimeDiv);
+    if (m_midiTimeDiv < 0)
+        RaiseError("unsupported MIDI time division (%d)", m_midiTimeDiv);
 }
 
-long ReadMidiTrackHeader(long offset)
+long Song::ReadMidiTrackHeader(long offset)
 {
     Seek(offset);
 
@@ -162,45 +139,45 @@ long ReadMidiTrackHeader(long offset)
 
     long size = ReadInt32();
 
-    s_trackDataStart = std::ftell(g_inputFile);
+    m_trackDataStart = m_midiPos;
 
     return size + 8;
 }
 
-void StartTrack()
+void Song::StartTrack()
 {
-    Seek(s_trackDataStart);
-    s_absoluteTime = 0;
-    s_runningStatus = 0;
+    Seek(m_trackDataStart);
+    m_absoluteTime = 0;
+    m_runningStatus = 0;
 }
 
-void SkipEventData()
+void Song::SkipEventData()
 {
     Skip(ReadVLQ());
 }
 
-void DetermineEventCategory(MidiEventCategory& category, int& typeChan, int& size)
+void Song::DetermineEventCategory(MidiEventCategory& category, int& typeChan, int& size)
 {
     typeChan = ReadInt8();
 
     if (typeChan < 0x80)
     {
         // If data byte was found, use the running status.
-        ungetc(typeChan, g_inputFile);
-        typeChan = s_runningStatus;
+        m_midiPos--;
+        typeChan = m_runningStatus;
     }
 
     if (typeChan == 0xFF)
     {
         category = MidiEventCategory::Meta;
         size = 0;
-        s_runningStatus = 0;
+        m_runningStatus = 0;
     }
     else if (typeChan >= 0xF0)
     {
         category = MidiEventCategory::SysEx;
         size = 0;
-        s_runningStatus = 0;
+        m_runningStatus = 0;
     }
     else if (typeChan >= 0x80)
     {
@@ -216,7 +193,7 @@ void DetermineEventCategory(MidiEventCategory& category, int& typeChan, int& siz
             size = 2;
             break;
         }
-        s_runningStatus = typeChan;
+        m_runningStatus = typeChan;
     }
     else
     {
@@ -224,22 +201,25 @@ void DetermineEventCategory(MidiEventCategory& category, int& typeChan, int& siz
     }
 }
 
-void MakeBlockEvent(Event& event, EventType type)
+void Song::MakeBlockEvent(Event& event, EventType type)
 {
     event.type = type;
-    event.param1 = s_blockCount++;
+    event.param1 = m_blockCount++;
     event.param2 = 0;
 }
 
-std::string ReadEventText()
+std::string Song::ReadEventText()
 {
     char buffer[2];
     std::uint32_t length = ReadVLQ();
 
     if (length <= 2)
     {
-        if (fread(buffer, length, 1, g_inputFile) != 1)
+        if (m_midiPos + (long)length > (long)m_midiData.size())
             RaiseError("failed to read event text");
+
+        std::copy(&m_midiData[m_midiPos], &m_midiData[m_midiPos] + length, buffer);
+        m_midiPos += length;
     }
     else
     {
@@ -250,10 +230,10 @@ std::string ReadEventText()
     return std::string(buffer, length);
 }
 
-bool ReadSeqEvent(Event& event)
+bool Song::ReadSeqEvent(Event& event)
 {
-    s_absoluteTime += ReadVLQ();
-    event.time = s_absoluteTime;
+    m_absoluteTime += ReadVLQ();
+    event.time = m_absoluteTime;
 
     MidiEventCategory category;
     int typeChan;
@@ -326,7 +306,7 @@ bool ReadSeqEvent(Event& event)
 
             Skip(2); // ignore other values
 
-            int clockTicks = 96 * numerator * g_clocksPerBeat;
+            int clockTicks = 96 * numerator * m_options.clocksPerBeat;
             int denominator = 1 << denominatorExponent;
             int timeSig = clockTicks / denominator;
 
@@ -347,7 +327,7 @@ bool ReadSeqEvent(Event& event)
     return true;
 }
 
-void ReadSeqEvents()
+void Song::ReadSeqEvents()
 {
     StartTrack();
 
@@ -357,7 +337,7 @@ void ReadSeqEvents()
 
         if (ReadSeqEvent(event))
         {
-            s_seqEvents.push_back(event);
+            m_seqEvents.push_back(event);
 
             if (event.type == EventType::EndOfTrack)
                 return;
@@ -365,7 +345,7 @@ void ReadSeqEvents()
     }
 }
 
-bool CheckNoteEnd(Event& event)
+bool Song::CheckNoteEnd(Event& event)
 {
     event.param2 += ReadVLQ();
 
@@ -379,7 +359,7 @@ bool CheckNoteEnd(Event& event)
     {
         int chan = typeChan & 0xF;
 
-        if (chan != g_midiChan)
+        if (chan != m_midiChan)
         {
             Skip(size);
             return false;
@@ -431,12 +411,12 @@ bool CheckNoteEnd(Event& event)
     RaiseError("invalid event");
 }
 
-void FindNoteEnd(Event& event)
+void Song::FindNoteEnd(Event& event)
 {
     // Save the current file position and running status
     // which get modified by CheckNoteEnd.
-    long startPos = ftell(g_inputFile);
-    int savedRunningStatus = s_runningStatus;
+    long startPos = m_midiPos;
+    int savedRunningStatus = m_runningStatus;
 
     event.param2 = 0;
 
@@ -444,13 +424,13 @@ void FindNoteEnd(Event& event)
         ;
 
     Seek(startPos);
-    s_runningStatus = savedRunningStatus;
+    m_runningStatus = savedRunningStatus;
 }
 
-bool ReadTrackEvent(Event& event)
+bool Song::ReadTrackEvent(Event& event)
 {
-    s_absoluteTime += ReadVLQ();
-    event.time = s_absoluteTime;
+    m_absoluteTime += ReadVLQ();
+    event.time = m_absoluteTime;
 
     MidiEventCategory category;
     int typeChan;
@@ -462,7 +442,7 @@ bool ReadTrackEvent(Event& event)
     {
         int chan = typeChan & 0xF;
 
-        if (chan != g_midiChan)
+        if (chan != m_midiChan)
         {
             Skip(size);
             return false;
@@ -483,10 +463,10 @@ bool ReadTrackEvent(Event& event)
                 FindNoteEnd(event);
                 if (event.param2 > 0)
                 {
-                    if (note < s_minNote)
-                        s_minNote = note;
-                    if (note > s_maxNote)
-                        s_maxNote = note;
+                    if (note < m_minNote)
+                        m_minNote = note;
+                    if (note > m_maxNote)
+                        m_maxNote = note;
                 }
             }
             break;
@@ -539,14 +519,14 @@ bool ReadTrackEvent(Event& event)
     RaiseError("invalid event");
 }
 
-void ReadTrackEvents()
+void Song::ReadTrackEvents()
 {
     StartTrack();
 
-    s_trackEvents.clear();
+    m_trackEvents.clear();
 
-    s_minNote = 0xFF;
-    s_maxNote = 0;
+    m_minNote = 0xFF;
+    m_maxNote = 0;
 
     for (;;)
     {
@@ -554,7 +534,7 @@ void ReadTrackEvents()
 
         if (ReadTrackEvent(event))
         {
-            s_trackEvents.push_back(event);
+            m_trackEvents.push_back(event);
 
             if (event.type == EventType::EndOfTrack)
                 return;
@@ -562,7 +542,7 @@ void ReadTrackEvents()
     }
 }
 
-bool EventCompare(const Event& event1, const Event& event2)
+static bool EventCompare(const Event& event1, const Event& event2)
 {
     if (event1.time < event2.time)
         return true;
@@ -597,53 +577,53 @@ bool EventCompare(const Event& event1, const Event& event2)
     return false;
 }
 
-std::unique_ptr<std::vector<Event>> MergeEvents()
+std::unique_ptr<std::vector<Event>> Song::MergeEvents()
 {
     std::unique_ptr<std::vector<Event>> events(new std::vector<Event>());
 
     unsigned trackEventPos = 0;
     unsigned seqEventPos = 0;
 
-    while (s_trackEvents[trackEventPos].type != EventType::EndOfTrack
-        && s_seqEvents[seqEventPos].type != EventType::EndOfTrack)
+    while (m_trackEvents[trackEventPos].type != EventType::EndOfTrack
+        && m_seqEvents[seqEventPos].type != EventType::EndOfTrack)
     {
-        if (EventCompare(s_trackEvents[trackEventPos], s_seqEvents[seqEventPos]))
-            events->push_back(s_trackEvents[trackEventPos++]);
+        if (EventCompare(m_trackEvents[trackEventPos], m_seqEvents[seqEventPos]))
+            events->push_back(m_trackEvents[trackEventPos++]);
         else
-            events->push_back(s_seqEvents[seqEventPos++]);
+            events->push_back(m_seqEvents[seqEventPos++]);
     }
 
-    while (s_trackEvents[trackEventPos].type != EventType::EndOfTrack)
-        events->push_back(s_trackEvents[trackEventPos++]);
+    while (m_trackEvents[trackEventPos].type != EventType::EndOfTrack)
+        events->push_back(m_trackEvents[trackEventPos++]);
 
-    while (s_seqEvents[seqEventPos].type != EventType::EndOfTrack)
-        events->push_back(s_seqEvents[seqEventPos++]);
+    while (m_seqEvents[seqEventPos].type != EventType::EndOfTrack)
+        events->push_back(m_seqEvents[seqEventPos++]);
 
     // Push the EndOfTrack event with the larger time.
-    if (EventCompare(s_trackEvents[trackEventPos], s_seqEvents[seqEventPos]))
-        events->push_back(s_seqEvents[seqEventPos]);
+    if (EventCompare(m_trackEvents[trackEventPos], m_seqEvents[seqEventPos]))
+        events->push_back(m_seqEvents[seqEventPos]);
     else
-        events->push_back(s_trackEvents[trackEventPos]);
+        events->push_back(m_trackEvents[trackEventPos]);
 
     return events;
 }
 
-void ConvertTimes(std::vector<Event>& events)
+void Song::ConvertTimes(std::vector<Event>& events)
 {
     for (Event& event : events)
     {
-        event.time = (24 * g_clocksPerBeat * event.time) / g_midiTimeDiv;
+        event.time = (24 * m_options.clocksPerBeat * event.time) / m_midiTimeDiv;
 
         if (event.type == EventType::Note)
         {
             event.param1 = g_noteVelocityLUT[event.param1];
 
-            std::uint32_t duration = (24 * g_clocksPerBeat * event.param2) / g_midiTimeDiv;
+            std::uint32_t duration = (24 * m_options.clocksPerBeat * event.param2) / m_midiTimeDiv;
 
             if (duration == 0)
                 duration = 1;
 
-            if (!g_exactGateTime && duration < 96)
+            if (!m_options.exactGateTime && duration < 96)
                 duration = g_noteDurationLUT[duration];
 
             event.param2 = duration;
@@ -651,14 +631,14 @@ void ConvertTimes(std::vector<Event>& events)
     }
 }
 
-std::unique_ptr<std::vector<Event>> InsertTimingEvents(std::vector<Event>& inEvents)
+std::unique_ptr<std::vector<Event>> Song::InsertTimingEvents(std::vector<Event>& inEvents)
 {
     std::unique_ptr<std::vector<Event>> outEvents(new std::vector<Event>());
 
     Event timingEvent = {};
     timingEvent.time = 0;
     timingEvent.type = EventType::TimeSignature;
-    timingEvent.param2 = 96 * g_clocksPerBeat;
+    timingEvent.param2 = 96 * m_options.clocksPerBeat;
 
     for (const Event& event : inEvents)
     {
@@ -670,7 +650,7 @@ std::unique_ptr<std::vector<Event>> InsertTimingEvents(std::vector<Event>& inEve
 
         if (event.type == EventType::TimeSignature)
         {
-            if (g_agbTrack == 1 && event.param2 != timingEvent.param2)
+            if (m_agbTrack == 1 && event.param2 != timingEvent.param2)
             {
                 Event originalTimingEvent = event;
                 originalTimingEvent.type = EventType::OriginalTimeSignature;
@@ -686,7 +666,7 @@ std::unique_ptr<std::vector<Event>> InsertTimingEvents(std::vector<Event>& inEve
     return outEvents;
 }
 
-std::unique_ptr<std::vector<Event>> SplitTime(std::vector<Event>& inEvents)
+std::unique_ptr<std::vector<Event>> Song::SplitTime(std::vector<Event>& inEvents)
 {
     std::unique_ptr<std::vector<Event>> outEvents(new std::vector<Event>());
 
@@ -729,7 +709,7 @@ std::unique_ptr<std::vector<Event>> SplitTime(std::vector<Event>& inEvents)
     return outEvents;
 }
 
-std::unique_ptr<std::vector<Event>> CreateTies(std::vector<Event>& inEvents)
+std::unique_ptr<std::vector<Event>> Song::CreateTies(std::vector<Event>& inEvents)
 {
     std::unique_ptr<std::vector<Event>> outEvents(new std::vector<Event>());
 
@@ -756,9 +736,9 @@ std::unique_ptr<std::vector<Event>> CreateTies(std::vector<Event>& inEvents)
     return outEvents;
 }
 
-void CalculateWaits(std::vector<Event>& events)
+void Song::CalculateWaits(std::vector<Event>& events)
 {
-    g_initialWait = events[0].time;
+    m_initialWait = events[0].time;
     int wholeNoteCount = 0;
 
     for (unsigned i = 0; i < events.size() && events[i].type != EventType::EndOfTrack; i++)
@@ -773,7 +753,7 @@ void CalculateWaits(std::vector<Event>& events)
     }
 }
 
-int CalculateCompressionScore(std::vector<Event>& events, int index)
+static int CalculateCompressionScore(std::vector<Event>& events, int index)
 {
     int score = 0;
     std::uint8_t lastParam1 = events[index].param1;
@@ -850,7 +830,7 @@ int CalculateCompressionScore(std::vector<Event>& events, int index)
     return score;
 }
 
-bool IsCompressionMatch(std::vector<Event>& events, int index1, int index2)
+static bool IsCompressionMatch(std::vector<Event>& events, int index1, int index2)
 {
     if (events[index1].type != events[index2].type ||
         events[index1].note != events[index2].note ||
@@ -873,76 +853,189 @@ bool IsCompressionMatch(std::vector<Event>& events, int index1, int index2)
     return IsPatternBoundary(events[index2].type);
 }
 
-void CompressWholeNote(std::vector<Event>& events, int index)
+// Estimates the bytes saved by making the given whole note a pattern of its
+// own and replacing every later copy of it with a call.
+static int SingleWholeNoteSaving(std::vector<Event>& events, std::vector<int>& wholeNotes, std::vector<int>& scores, std::vector<bool>& used, int k)
 {
-    for (int j = index + 1; events[j].type != EventType::EndOfTrack; j++)
-    {
-        while (events[j].type != EventType::WholeNoteMark)
-        {
-            j++;
+    if (scores[k] < 6)
+        return 0;
 
-            if (events[j].type == EventType::EndOfTrack)
-                return;
-        }
+    int callCount = 0;
 
-        if (IsCompressionMatch(events, index, j))
-        {
-            events[j].type = EventType::Pattern;
-            events[j].param2 = events[index].param2 & 0x7FFFFFFF;
-            events[index].param2 |= 0x80000000;
-        }
+    for (unsigned m = k + 1; m < wholeNotes.size(); m++)
+    {
+        if (!used[m] && IsCompressionMatch(events, wholeNotes[k], wholeNotes[m]))
+            callCount++;
     }
+
+    return callCount > 0 ? callCount * (scores[k] - 5) - 1 : 0;
 }
 
-void Compress(std::vector<Event>& events)
+// Finds repeated runs of whole notes and factors them out into patterns.
+// Each whole note not already inside a pattern is tried as the start of a
+// pattern, and the run length is chosen by estimating the bytes saved: every
+// later copy of the run becomes a 5-byte PATT call, and the pattern itself
+// gains a 1-byte PEND. Single whole notes keep the original score threshold,
+// so a longer run is only used when it saves more than that would.
+//
+// The patternLength of a pattern's WholeNoteMark and of every Pattern event
+// referencing it holds the number of whole notes the pattern spans.
+static void Compress(std::vector<Event>& events)
 {
+    std::vector<int> wholeNotes;
+
     for (int i = 0; events[i].type != EventType::EndOfTrack; i++)
     {
-        while (events[i].type != EventType::WholeNoteMark)
+        if (events[i].type == EventType::WholeNoteMark)
+            wholeNotes.push_back(i);
+    }
+
+    int count = wholeNotes.size();
+    std::vector<int> scores(count);
+    std::vector<bool> continues(count);
+    std::vector<bool> used(count, false);
+
+    for (int k = 0; k < count; k++)
+    {
+        scores[k] = CalculateCompressionScore(events, wholeNotes[k]);
+
+        // A pattern can only run on into the next whole note if nothing
+        // else that ends a pattern comes between them.
+        int end = wholeNotes[k] + 1;
+
+        while (!IsPatternBoundary(events[end].type))
+            end++;
+
+        continues[k] = (k + 1 < count && end == wholeNotes[k + 1]);
+    }
+
+    for (int k = 0; k < count; k++)
+    {
+        if (used[k])
+            continue;
+
+        // Find every later copy of this whole note and how long the
+        // repeated run starting there is.
+        std::vector<int> matches;
+        std::vector<int> runLengths;
+        int maxRunLength = 0;
+
+        for (int m = k + 1; m < count; m++)
         {
-            i++;
+            if (used[m] || !IsCompressionMatch(events, wholeNotes[k], wholeNotes[m]))
+                continue;
+
+            int length = 1;
+
+            while (k + length < m
+                && m + length < count
+                && continues[k + length - 1]
+                && continues[m + length - 1]
+                && !used[k + length]
+                && !used[m + length]
+                && IsCompressionMatch(events, wholeNotes[k + length], wholeNotes[m + length]))
+                length++;
+
+            matches.push_back(m);
+            runLengths.push_back(length);
+            maxRunLength = std::max(maxRunLength, length);
+        }
 
-            if (events[i].type == EventType::EndOfTrack)
-                return;
+        int bestLength = 0;
+        int bestSaving = 0;
+        int runScore = 0;
+        int forfeitedSaving = 0;
+
+        for (int length = 1; length <= maxRunLength; length++)
+        {
+            runScore += scores[k + length - 1];
+
+            int callCount = 0;
+            int nextFree = 0;
+
+            for (unsigned j = 0; j < matches.size(); j++)
+            {
+                if (runLengths[j] >= length && matches[j] >= nextFree)
+                {
+                    callCount++;
+                    nextFree = matches[j] + length;
+                }
+            }
+
+            // Whole notes swallowed by a longer run can't become patterns
+            // of their own, so a run has to beat what they would have saved.
+            if (length > 1)
+                forfeitedSaving += SingleWholeNoteSaving(events, wholeNotes, scores, used, k + length - 1);
+
+            int saving = callCount * (runScore - 5) - 1 - forfeitedSaving;
+
+            if (length == 1 ? runScore >= 6 : saving > bestSaving)
+            {
+                bestLength = length;
+                bestSaving = saving;
+            }
         }
 
-        if (CalculateCompressionScore(events, i) >= 6)
+        if (bestLength == 0)
+            continue;
+
+        Event& patternStart = events[wholeNotes[k]];
+        int nextFree = 0;
+
+        for (unsigned j = 0; j < matches.size(); j++)
         {
-            CompressWholeNote(events, i);
+            if (runLengths[j] < bestLength || matches[j] < nextFree)
+                continue;
+
+            Event& call = events[wholeNotes[matches[j]]];
+            call.type = EventType::Pattern;
+            call.patternLength = bestLength;
+            call.param2 = patternStart.param2 & 0x7FFFFFFF;
+
+            for (int n = 0; n < bestLength; n++)
+                used[matches[j] + n] = true;
+
+            nextFree = matches[j] + bestLength;
         }
+
+        patternStart.patternLength = bestLength;
+        patternStart.param2 |= 0x80000000;
+
+        for (int n = 0; n < bestLength; n++)
+            used[k + n] = true;
     }
 }
 
-void ReadMidiTracks()
+void Song::ReadMidiTracks()
 {
     long trackHeaderStart = 14;
 
     ReadMidiTrackHeader(trackHeaderStart);
     ReadSeqEvents();
 
-    g_agbTrack = 1;
+    m_agbTrack = 1;
 
-    for (int midiTrack = 0; midiTrack < g_midiTrackCount; midiTrack++)
+    for (int midiTrack = 0; midiTrack < m_midiTrackCount; midiTrack++)
     {
         trackHeaderStart += ReadMidiTrackHeader(trackHeaderStart);
 
-        for (g_midiChan = 0; g_midiChan < 16; g_midiChan++)
+        for (m_midiChan = 0; m_midiChan < 16; m_midiChan++)
         {
             ReadTrackEvents();
 
-            if (s_minNote != 0xFF)
+            if (m_minNote != 0xFF)
             {
 #ifdef DEBUG
-                printf("Track%d = Midi-Ch.%d\n", g_agbTrack, g_midiChan + 1);
+                printf("Track%d = Midi-Ch.%d\n", m_agbTrack, m_midiChan + 1);
 #endif
 
                 std::unique_ptr<std::vector<Event>> events(MergeEvents());
 
                 // We don't need TEMPO in anything but track 1.
-                if (g_agbTrack == 1)
+                if (m_agbTrack == 1)
                 {
-                    auto it = std::remove_if(s_seqEvents.begin(), s_seqEvents.end(), [](const Event& event) { return event.type == EventType::Tempo; });
-                    s_seqEvents.erase(it, s_seqEvents.end());
+                    auto it = std::remove_if(m_seqEvents.begin(), m_seqEvents.end(), [](const Event& event) { return event.type == EventType::Tempo; });
+                    m_seqEvents.erase(it, m_seqEvents.end());
                 }
 
                 ConvertTimes(*events);
@@ -952,13 +1045,28 @@ void ReadMidiTracks()
                 events = SplitTime(*events);
                 CalculateWaits(*events);
 
-                if (g_compressionEnabled)
+                if (m_options.compressionEnabled)
                     Compress(*events);
 
                 PrintAgbTrack(*events);
 
-                g_agbTrack++;
+                m_agbTrack++;
             }
         }
     }
 }
+
+Song::Song(const SongOptions& options, std::vector<std::uint8_t> midiData)
+    : m_options(options), m_midiData(std::move(midiData))
+{
+}
+
+std::string Song::Convert()
+{
+    ReadMidiFileHeader();
+    PrintAgbHeader();
+    ReadMidiTracks();
+    PrintAgbFooter();
+
+    return std::move(m_output);
+}
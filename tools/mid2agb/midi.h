@@ -29,6 +29,14 @@ enum class MidiFormat
     MultiTrack
 };
 
+enum class MidiEventCategory
+{
+    Control,
+    SysEx,
+    Meta,
+    Invalid,
+};
+
 enum class EventType
 {
     EndOfTie = 0x01,
@@ -57,6 +65,7 @@ struct Event
     std::uint8_t note;
     std::uint8_t param1;
     std::int32_t param2;
+    std::int32_t patternLength; // whole notes spanned, on a pattern's WholeNoteMark and its Pattern calls
 
     bool operator==(const Event& other)
     {
@@ -64,7 +73,8 @@ struct Event
             && type == other.type
             && note == other.note
             && param1 == other.param1
-            && param2 == other.param2);
+            && param2 == other.param2
+            && patternLength == other.patternLength);
     }
 
     bool operator!=(const Event& other)
@@ -73,12 +83,6 @@ struct Event
     }
 };
 
-void ReadMidiFileHeader();
-void ReadMidiTracks();
-
-extern int g_midiChan;
-extern std::int32_t g_initialWait;
-
 inline bool IsPatternBoundary(EventType type)
 {
     return type == EventType::EndOfTrack || (int)type <= 0x17;
@@ -0,0 +1,388 @@
+// Checks that two mid2agb outputs for the same song play the same way.
+//
+// Each track is walked the way the m4a player runs it: PATT calls are
+// expanded, running status and the omitted key and velocity of notes are
+// filled in, and consecutive waits are merged. The resulting command streams
+// are compared track by track. It is meant for comparing a song converted
+// with -N against the same song with compression on.
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+struct Line
+{
+    enum Kind { Label, Byte, Word } kind;
+    std::vector<std::string> tokens; // label name, or comma separated operands
+    int lineNum;
+};
+
+struct SeqFile
+{
+    std::string filename;
+    std::vector<Line> lines;
+    std::map<std::string, int> labels;
+    std::vector<int> trackStarts;
+};
+
+static bool s_error;
+
+static void Error(const SeqFile& file, int lineNum, const char* format, const std::string& arg)
+{
+    std::fprintf(stderr, "%s:%d: ", file.filename.c_str(), lineNum);
+    std::fprintf(stderr, format, arg.c_str());
+    std::fprintf(stderr, "\n");
+    s_error = true;
+}
+
+static std::string Trim(const std::string& s)
+{
+    std::size_t begin = s.find_first_not_of(" \t");
+
+    if (begin == std::string::npos)
+        return "";
+
+    return s.substr(begin, s.find_last_not_of(" \t") + 1 - begin);
+}
+
+static std::vector<std::string> SplitOperands(const std::string& s)
+{
+    std::vector<std::string> tokens;
+    std::size_t start = 0;
+
+    for (;;)
+    {
+        std::size_t comma = s.find(',', start);
+        tokens.push_back(Trim(s.substr(start, comma - start)));
+
+        if (comma == std::string::npos)
+            break;
+
+        start = comma + 1;
+    }
+
+    return tokens;
+}
+
+static bool ReadSeqFile(const char* filename, SeqFile& file)
+{
+    FILE* fp = std::fopen(filename, "r");
+
+    if (fp == nullptr)
+    {
+        std::fprintf(stderr, "failed to open \"%s\" for reading\n", filename);
+        return false;
+    }
+
+    file.filename = filename;
+
+    std::string asmLabel;
+    char buffer[1024];
+    int lineNum = 0;
+
+    while (std::fgets(buffer, sizeof(buffer), fp) != nullptr)
+    {
+        lineNum++;
+
+        std::string text = buffer;
+        std::size_t comment = text.find('@');
+
+        if (comment != std::string::npos)
+            text.erase(comment);
+
+        text = Trim(text.substr(0, text.find_last_not_of("\r\n") + 1));
+
+        if (text.empty())
+            continue;
+
+        if (text.compare(0, 5, ".equ\t") == 0 && text.find("_grp,") != std::string::npos)
+        {
+            asmLabel = text.substr(5, text.find("_grp,") - 5);
+            continue;
+        }
+
+        Line line;
+        line.lineNum = lineNum;
+
+        if (text.back() == ':')
+        {
+            line.kind = Line::Label;
+            line.tokens.push_back(text.substr(0, text.size() - 1));
+
+            // The song header follows the tracks.
+            if (line.tokens[0] == asmLabel)
+                break;
+
+            // Track labels are the asm label followed by the track number.
+            const std::string& name = line.tokens[0];
+
+            if (name.size() > asmLabel.size() + 1
+                && name.compare(0, asmLabel.size() + 1, asmLabel + "_") == 0
+                && name.find_first_not_of("0123456789", asmLabel.size() + 1) == std::string::npos)
+                file.trackStarts.push_back(file.lines.size());
+
+            file.labels[name] = file.lines.size();
+        }
+        else if (text.compare(0, 5, ".byte") == 0)
+        {
+            line.kind = Line::Byte;
+            line.tokens = SplitOperands(text.substr(5));
+        }
+        else if (text.compare(0, 5, ".word") == 0)
+        {
+            line.kind = Line::Word;
+            line.tokens = SplitOperands(text.substr(5));
+        }
+        else
+        {
+            continue;
+        }
+
+        file.lines.push_back(line);
+    }
+
+    std::fclose(fp);
+    return true;
+}
+
+static bool IsNoteCommand(const std::string& name)
+{
+    return name == "TIE" || (name.size() == 3 && name[0] == 'N' && std::isdigit(name[1]) && std::isdigit(name[2]));
+}
+
+static bool IsWait(const std::string& name)
+{
+    return name.size() == 3 && name[0] == 'W' && std::isdigit(name[1]) && std::isdigit(name[2]);
+}
+
+// Commands the player keeps as running status, so a following line with only
+// operands repeats them.
+static bool SetsRunningStatus(const std::string& name)
+{
+    static const std::set<std::string> s_names = {
+        "VOICE", "VOL", "PAN", "BEND", "BENDR", "LFOS", "LFODL", "MOD", "MODT", "TUNE", "XCMD", "EOT",
+    };
+
+    return IsNoteCommand(name) || s_names.count(name) != 0;
+}
+
+static bool IsCommand(const std::string& name)
+{
+    static const std::set<std::string> s_names = {
+        "FINE", "GOTO", "PATT", "PEND", "REPT", "MEMACC", "PRIO", "TEMPO", "KEYSH",
+    };
+
+    return IsWait(name) || SetsRunningStatus(name) || s_names.count(name) != 0;
+}
+
+// Walks a track from its label to FINE and returns the commands it plays.
+static std::vector<std::string> ExpandTrack(const SeqFile& file, int start, const std::set<std::string>& patternLabels)
+{
+    std::vector<std::string> commands;
+    std::vector<int> callStack;
+    std::string runningStatus;
+    std::string lastKey;
+    std::string lastVelocity;
+    int pendingWait = 0;
+    std::set<int> trackStarts(file.trackStarts.begin(), file.trackStarts.end());
+    int pc = start + 1;
+
+    for (;;)
+    {
+        if (pc >= (int)file.lines.size() || trackStarts.count(pc) != 0)
+        {
+            Error(file, file.lines[start].lineNum, "track %s runs off its end", file.lines[start].tokens[0]);
+            break;
+        }
+
+        const Line& line = file.lines[pc++];
+
+        if (line.kind == Line::Label)
+        {
+            // Loop labels are where GOTOs land, so they have to stay put.
+            if (patternLabels.count(line.tokens[0]) == 0)
+            {
+                if (pendingWait != 0)
+                    commands.push_back("W" + std::to_string(pendingWait));
+
+                pendingWait = 0;
+                commands.push_back(line.tokens[0] + ":");
+            }
+            continue;
+        }
+
+        if (line.kind == Line::Word)
+        {
+            Error(file, line.lineNum, "unexpected .word %s", line.tokens[0]);
+            continue;
+        }
+
+        std::vector<std::string> operands = line.tokens;
+        std::string name = operands[0];
+
+        if (IsCommand(name))
+            operands.erase(operands.begin());
+        else if (!runningStatus.empty())
+            name = runningStatus;
+        else
+            Error(file, line.lineNum, "operands %s with no running status", name);
+
+        if (IsWait(name))
+        {
+            pendingWait += std::atoi(name.c_str() + 1);
+            continue;
+        }
+
+        if (SetsRunningStatus(name))
+            runningStatus = name;
+
+        std::string command = name;
+
+        if (name == "PATT" || name == "GOTO")
+        {
+            if (pc >= (int)file.lines.size() || file.lines[pc].kind != Line::Word)
+            {
+                Error(file, line.lineNum, "%s has no target", name);
+                break;
+            }
+
+            std::string target = file.lines[pc++].tokens[0];
+
+            if (file.labels.count(target) == 0)
+            {
+                Error(file, line.lineNum, "unknown label %s", target);
+                break;
+            }
+
+            if (name == "PATT")
+            {
+                if (callStack.size() >= 3)
+                {
+                    Error(file, line.lineNum, "patterns nested too deeply at %s", target);
+                    break;
+                }
+
+                callStack.push_back(pc);
+                pc = file.labels.at(target);
+                continue;
+            }
+
+            command += " " + target;
+        }
+        else if (name == "PEND")
+        {
+            // The player ignores a PEND it reaches without a call.
+            if (!callStack.empty())
+            {
+                pc = callStack.back();
+                callStack.pop_back();
+            }
+            continue;
+        }
+        else if (IsNoteCommand(name) || name == "EOT")
+        {
+            if (operands.size() > 0 && !operands[0].empty())
+                lastKey = operands[0];
+
+            command += " " + lastKey;
+
+            if (name != "EOT")
+            {
+                if (operands.size() > 1)
+                    lastVelocity = operands[1];
+
+                command += " " + lastVelocity;
+
+                if (operands.size() > 2)
+                    command += " " + operands[2];
+            }
+        }
+        else
+        {
+            for (const std::string& operand : operands)
+                command += " " + operand;
+        }
+
+        // PATT and PEND don't take any time, so waits on either side of
+        // them are only flushed here.
+        if (pendingWait != 0)
+            commands.push_back("W" + std::to_string(pendingWait));
+
+        pendingWait = 0;
+        commands.push_back(command);
+
+        if (name == "FINE")
+            break;
+    }
+
+    return commands;
+}
+
+static std::vector<std::vector<std::string>> ExpandSong(const SeqFile& file)
+{
+    std::set<std::string> patternLabels;
+
+    for (unsigned i = 0; i + 1 < file.lines.size(); i++)
+    {
+        if (file.lines[i].kind == Line::Byte && file.lines[i].tokens[0] == "PATT" && file.lines[i + 1].kind == Line::Word)
+            patternLabels.insert(file.lines[i + 1].tokens[0]);
+    }
+
+    std::vector<std::vector<std::string>> tracks;
+
+    for (int start : file.trackStarts)
+        tracks.push_back(ExpandTrack(file, start, patternLabels));
+
+    return tracks;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::fprintf(stderr, "Usage: seqcheck reference.s converted.s\n");
+        return 2;
+    }
+
+    SeqFile files[2];
+
+    if (!ReadSeqFile(argv[1], files[0]) || !ReadSeqFile(argv[2], files[1]))
+        return 2;
+
+    std::vector<std::vector<std::string>> tracks[2] = { ExpandSong(files[0]), ExpandSong(files[1]) };
+
+    if (s_error)
+        return 1;
+
+    if (tracks[0].size() != tracks[1].size())
+    {
+        std::fprintf(stderr, "%s: %u tracks, but %s has %u\n", argv[2], (unsigned)tracks[1].size(), argv[1], (unsigned)tracks[0].size());
+        return 1;
+    }
+
+    for (unsigned t = 0; t < tracks[0].size(); t++)
+    {
+        const std::vector<std::string>& a = tracks[0][t];
+        const std::vector<std::string>& b = tracks[1][t];
+        unsigned i = 0;
+
+        while (i < a.size() && i < b.size() && a[i] == b[i])
+            i++;
+
+        if (i < a.size() || i < b.size())
+        {
+            std::fprintf(stderr, "%s: track %u differs from %s at command %u: \"%s\" vs \"%s\"\n",
+                argv[2], t + 1, argv[1], i,
+                i < b.size() ? b[i].c_str() : "(end)",
+                i < a.size() ? a[i].c_str() : "(end)");
+            s_error = true;
+        }
+    }
+
+    return s_error ? 1 : 0;
+}
@@ -4,10 +4,12 @@
 #include <map>
 #include <vector>
 #include <string>
+#include <algorithm>
 #include "ramscrgen.h"
 #include "elf.h"
 
 #define SHN_COMMON 0xFFF2
+#define STT_OBJECT 1
 
 static std::string s_elfPath;
 static std::string s_archiveFilePath;
@@ -202,6 +204,20 @@ static void FindTableOffsets()
         FATAL_ERROR("error: couldn't find .strtab section in \"%s\"\n", s_elfPath.c_str());
 }
 
+static int FindSection(std::string sectionName)
+{
+    Seek(s_sectionHeaderOffset + s_sectionHeaderEntrySize * s_shstrtabIndex + 0x10);
+    std::uint32_t shstrtabOffset = ReadInt32();
+
+    for (int i = 0; i < s_sectionCount; i++)
+    {
+        if (GetSectionName(shstrtabOffset, i) == sectionName)
+            return i;
+    }
+
+    return -1;
+}
+
 static std::map<std::string, std::uint32_t> GetCommonSymbols_Shared()
 {
     VerifyElfIdent();
@@ -236,7 +252,7 @@ static std::map<std::string, std::uint32_t> GetCommonSymbols_Shared()
     return commonSymbols;
 }
 
-std::map<std::string, std::uint32_t> GetCommonSymbolsFromLib(std::string sourcePath, std::string libpath)
+static void OpenLibObject(std::string sourcePath, std::string libpath)
 {
     std::size_t colonPos = libpath.find(':');
     if (colonPos == std::string::npos)
@@ -253,20 +269,83 @@ std::map<std::string, std::uint32_t> GetCommonSymbolsFromLib(std::string sourceP
 
     VerifyAr();
     FindArObj();
-    return GetCommonSymbols_Shared();
 }
 
-std::map<std::string, std::uint32_t> GetCommonSymbols(std::string sourcePath, std::string path)
+static void OpenObject(std::string sourcePath, std::string path)
 {
     s_elfFileOffset = 0;
     if (path[0] == '*')
-        return GetCommonSymbolsFromLib(sourcePath, path);
+    {
+        OpenLibObject(sourcePath, path);
+        return;
+    }
 
     s_elfPath = sourcePath + "/" + path;
     s_file = std::fopen(s_elfPath.c_str(), "rb");
 
     if (s_file == NULL)
         FATAL_ERROR("error: failed to open \"%s\" for reading\n", path.c_str());
+}
+
+std::map<std::string, std::uint32_t> GetCommonSymbols(std::string sourcePath, std::string path)
+{
+    OpenObject(sourcePath, path);
+    auto commonSymbols = GetCommonSymbols_Shared();
+    std::fclose(s_file);
+    return commonSymbols;
+}
+
+SectionLayout GetSectionLayout(std::string sourcePath, std::string path, std::string sectionName)
+{
+    OpenObject(sourcePath, path);
+    VerifyElfIdent();
+    ReadElfHeader();
+
+    SectionLayout layout = {};
+    int sectionIndex = FindSection(sectionName);
+
+    if (sectionIndex < 0)
+    {
+        std::fclose(s_file);
+        return layout;
+    }
+
+    Seek(s_sectionHeaderOffset + s_sectionHeaderEntrySize * sectionIndex + 0x14);
+    layout.size = ReadInt32();
+    Skip(8);
+    layout.alignment = ReadInt32();
+
+    FindTableOffsets();
+
+    std::vector<std::uint32_t> nameOffsets;
+
+    Seek(s_symtabOffset);
+
+    for (std::uint32_t i = 0; i < s_symbolCount; i++)
+    {
+        std::uint32_t nameOffset = ReadInt32();
+        std::uint32_t value = ReadInt32();
+        std::uint32_t size = ReadInt32();
+        std::uint32_t info = ReadInt8();
+        Skip(1);
+        std::uint16_t symSectionIndex = ReadInt16();
+        if (symSectionIndex == sectionIndex && (info & 0xF) == STT_OBJECT)
+        {
+            nameOffsets.push_back(nameOffset);
+            layout.symbols.push_back({ "", value, size });
+        }
+    }
+
+    for (std::size_t i = 0; i < layout.symbols.size(); i++)
+    {
+        Seek(s_strtabOffset + nameOffsets[i]);
+        layout.symbols[i].name = ReadString();
+    }
+
+    std::stable_sort(layout.symbols.begin(), layout.symbols.end(), [](const SectionSymbol& a, const SectionSymbol& b) {
+        return a.offset < b.offset;
+    });
 
-    return GetCommonSymbols_Shared();
+    std::fclose(s_file);
+    return layout;
 }
@@ -24,7 +24,23 @@
 #include <cstdint>
 #include <map>
 #include <string>
+#include <vector>
+
+struct SectionSymbol
+{
+    std::string name;
+    std::uint32_t offset;
+    std::uint32_t size;
+};
+
+struct SectionLayout
+{
+    std::uint32_t size;
+    std::uint32_t alignment;
+    std::vector<SectionSymbol> symbols; // sorted by offset
+};
 
 std::map<std::string, std::uint32_t> GetCommonSymbols(std::string sourcePath, std::string path);
+SectionLayout GetSectionLayout(std::string sourcePath, std::string path, std::string sectionName);
 
 #endif // ELF_H
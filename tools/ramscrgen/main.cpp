@@ -21,13 +21,115 @@
 #include <cstdio>
 #include <cstring>
 #include <string>
+#include <vector>
 #include "ramscrgen.h"
 #include "sym_file.h"
 #include "elf.h"
 
-void HandleCommonInclude(std::string filename, std::string sourcePath, std::string symOrderPath, std::string lang)
+struct CommonEntry
+{
+    std::string label; // empty for a gap
+    unsigned long size;
+};
+
+struct MapEntry
+{
+    std::string name;
+    unsigned long address;
+    unsigned long size;
+    unsigned long padding;
+    bool isSymbol;
+};
+
+// The location counter, tracked the same way the linker will advance it,
+// so that the memory map and the packing pass know the real padding.
+static unsigned long s_location;
+static unsigned long s_pendingPadding;
+static std::vector<MapEntry> s_map;
+
+static unsigned long AlignLocation(unsigned long alignment)
+{
+    unsigned long padding = (alignment - s_location % alignment) % alignment;
+    s_location += padding;
+    s_pendingPadding += padding;
+    return padding;
+}
+
+static MapEntry& AddMapEntry(std::string name, unsigned long size, bool isSymbol)
+{
+    s_map.push_back({ name, s_location, size, s_pendingPadding, isSymbol });
+    s_pendingPadding = 0;
+    return s_map.back();
+}
+
+static unsigned long CommonSymbolAlignment(unsigned long size)
+{
+    int alignment = 4;
+    if (size > 4)
+        alignment = 8;
+    if (size > 8)
+        alignment = 16;
+    return alignment;
+}
+
+// Returns the padding needed to place the symbols in order from location.
+static unsigned long MeasurePadding(const std::vector<CommonEntry>& symbols, unsigned long location)
+{
+    unsigned long padding = 0;
+
+    for (const CommonEntry& symbol : symbols)
+    {
+        unsigned long alignment = CommonSymbolAlignment(symbol.size);
+        unsigned long symbolPadding = (alignment - location % alignment) % alignment;
+        padding += symbolPadding;
+        location += symbolPadding + symbol.size;
+    }
+
+    return padding;
+}
+
+// Reorders a run of common symbols to reduce the padding between them.
+// Each step places the symbol that needs the least padding at the current
+// location, preferring stricter alignments and then the original order.
+// The original order is kept unless the new one is strictly better.
+static void PackCommonSymbols(std::vector<CommonEntry>& symbols, unsigned long location)
+{
+    std::vector<CommonEntry> remaining = symbols;
+    std::vector<CommonEntry> packed;
+    unsigned long packedLocation = location;
+
+    while (!remaining.empty())
+    {
+        std::size_t best = 0;
+        unsigned long bestPadding = 0;
+        unsigned long bestAlignment = 0;
+
+        for (std::size_t i = 0; i < remaining.size(); i++)
+        {
+            unsigned long alignment = CommonSymbolAlignment(remaining[i].size);
+            unsigned long padding = (alignment - packedLocation % alignment) % alignment;
+
+            if (i == 0 || padding < bestPadding || (padding == bestPadding && alignment > bestAlignment))
+            {
+                best = i;
+                bestPadding = padding;
+                bestAlignment = alignment;
+            }
+        }
+
+        packedLocation += bestPadding + remaining[best].size;
+        packed.push_back(remaining[best]);
+        remaining.erase(remaining.begin() + best);
+    }
+
+    if (MeasurePadding(packed, location) < MeasurePadding(symbols, location))
+        symbols = packed;
+}
+
+void HandleCommonInclude(std::string filename, std::string sourcePath, std::string symOrderPath, std::string lang, bool pack)
 {
     auto commonSymbols = GetCommonSymbols(sourcePath, filename);
+    std::string objectName = filename;
     std::size_t dotIndex;
 
     if (filename[0] == '*') {
@@ -43,6 +145,7 @@ void HandleCommonInclude(std::string filename, std::string sourcePath, std::stri
     std::string symOrderFilename = filename.substr(0, dotIndex + 1) + "txt";
 
     SymFile symFile(symOrderPath + "/" + symOrderFilename);
+    std::vector<CommonEntry> entries;
 
     while (!symFile.IsAtEnd())
     {
@@ -57,29 +160,106 @@ void HandleCommonInclude(std::string filename, std::string sourcePath, std::stri
             {
                 if (length & 3)
                     symFile.RaiseWarning("gap length %d is not multiple of 4", length);
-                printf(". += 0x%lX;\n", length);
+                entries.push_back({ "", length });
             }
         }
         else
         {
             if (commonSymbols.count(label) == 0)
                 symFile.RaiseError("no common symbol named \"%s\"", label.c_str());
-            unsigned long size = commonSymbols[label];
-            int alignment = 4;
-            if (size > 4)
-                alignment = 8;
-            if (size > 8)
-                alignment = 16;
-            printf(". = ALIGN(%d);\n", alignment);
-            printf("%s = .;\n", label.c_str());
-            printf(". += 0x%lX;\n", size);
+            entries.push_back({ label, commonSymbols[label] });
         }
 
         symFile.ExpectEmptyRestOfLine();
     }
+
+    // Symbols are only ever reordered within the same object, and never
+    // across a gap, so explicit layouts in the order files are kept.
+    if (pack)
+    {
+        unsigned long location = s_location;
+        std::size_t runStart = 0;
+
+        for (std::size_t i = 0; i <= entries.size(); i++)
+        {
+            if (i < entries.size() && entries[i].label.length() != 0)
+                continue;
+
+            std::vector<CommonEntry> run(entries.begin() + runStart, entries.begin() + i);
+            PackCommonSymbols(run, location);
+            std::copy(run.begin(), run.end(), entries.begin() + runStart);
+
+            location += MeasurePadding(run, location);
+            for (const CommonEntry& symbol : run)
+                location += symbol.size;
+            if (i < entries.size())
+                location += entries[i].size;
+
+            runStart = i + 1;
+        }
+    }
+
+    std::size_t objectIndex = s_map.size();
+    unsigned long objectStart = s_location;
+    AddMapEntry(objectName, 0, false);
+
+    for (const CommonEntry& entry : entries)
+    {
+        if (entry.label.length() == 0)
+        {
+            printf(". += 0x%lX;\n", entry.size);
+            AddMapEntry("(gap)", entry.size, true);
+        }
+        else
+        {
+            unsigned long alignment = CommonSymbolAlignment(entry.size);
+            printf(". = ALIGN(%lu);\n", alignment);
+            printf("%s = .;\n", entry.label.c_str());
+            printf(". += 0x%lX;\n", entry.size);
+            s_map[objectIndex].padding += AlignLocation(alignment);
+            AddMapEntry(entry.label, entry.size, true);
+        }
+
+        s_location += entry.size;
+    }
+
+    s_map[objectIndex].size = s_location - objectStart;
+}
+
+// Records where the linker will put an object's input section. This needs
+// the object file itself, so it is only done when writing a memory map.
+void MapSectionInclude(std::string filename, std::string sectionName, std::string objectPath, std::string libSourcePath)
+{
+    SectionLayout layout = GetSectionLayout(filename[0] == '*' ? libSourcePath : objectPath, filename, sectionName);
+
+    if (layout.size == 0)
+        return;
+
+    if (layout.alignment > 1)
+        AlignLocation(layout.alignment);
+
+    std::size_t objectIndex = s_map.size();
+    unsigned long objectStart = s_location;
+    unsigned long end = 0;
+    AddMapEntry(filename, layout.size, false);
+
+    for (const SectionSymbol& symbol : layout.symbols)
+    {
+        s_location = objectStart + symbol.offset;
+        if (symbol.offset > end)
+        {
+            s_pendingPadding = symbol.offset - end;
+            s_map[objectIndex].padding += s_pendingPadding;
+        }
+        AddMapEntry(symbol.name, symbol.size, true);
+        if (symbol.offset + symbol.size > end)
+            end = symbol.offset + symbol.size;
+    }
+
+    s_location = objectStart + layout.size;
 }
 
-void ConvertSymFile(std::string filename, std::string sectionName, std::string lang, bool common, std::string sourcePath, std::string commonSymPath, std::string libSourcePath)
+void ConvertSymFile(std::string filename, std::string sectionName, std::string lang, bool common, std::string sourcePath, std::string commonSymPath, std::string libSourcePath, bool map, std::string objectPath, bool pack)
 {
     SymFile symFile(filename);
 
@@ -96,10 +276,17 @@ void ConvertSymFile(std::string filename, std::string sectionName, std::string l
             std::string incFilename = symFile.ReadPath();
             symFile.ExpectEmptyRestOfLine();
             printf(". = ALIGN(4);\n");
+            AlignLocation(4);
             if (common)
-                HandleCommonInclude(incFilename, incFilename[0] == '*' ? libSourcePath : sourcePath, commonSymPath, lang);
+            {
+                HandleCommonInclude(incFilename, incFilename[0] == '*' ? libSourcePath : sourcePath, commonSymPath, lang, pack);
+            }
             else
+            {
                 printf("%s(%s);\n", incFilename.c_str(), sectionName.c_str());
+                if (map)
+                    MapSectionInclude(incFilename, sectionName, objectPath, libSourcePath);
+            }
             break;
         }
         case Directive::Space:
@@ -109,6 +296,12 @@ void ConvertSymFile(std::string filename, std::string sectionName, std::string l
                 symFile.RaiseError("expected integer after .space directive");
             symFile.ExpectEmptyRestOfLine();
             printf(". += 0x%lX;\n", length);
+            // A label followed by .space reserves the space for that label.
+            if (!s_map.empty() && s_map.back().size == 0 && s_map.back().address == s_location && s_pendingPadding == 0)
+                s_map.back().size = length;
+            else
+                AddMapEntry("(space)", length, false);
+            s_location += length;
             break;
         }
         case Directive::Align:
@@ -121,6 +314,7 @@ void ConvertSymFile(std::string filename, std::string sectionName, std::string l
             amount = 1UL << amount;
             symFile.ExpectEmptyRestOfLine();
             printf(". = ALIGN(%lu);\n", amount);
+            AlignLocation(amount);
             break;
         }
         case Directive::Unknown:
@@ -130,6 +324,7 @@ void ConvertSymFile(std::string filename, std::string sectionName, std::string l
             if (label.length() != 0)
             {
                 printf("%s = .;\n", label.c_str());
+                AddMapEntry(label, 0, false);
             }
 
             symFile.ExpectEmptyRestOfLine();
@@ -140,48 +335,135 @@ void ConvertSymFile(std::string filename, std::string sectionName, std::string l
     }
 }
 
+void WriteMemoryMap(std::string mapFileName, std::string symFileName, std::string sectionName, unsigned long startAddress)
+{
+    FILE *fp = std::fopen(mapFileName.c_str(), "w");
+
+    if (fp == NULL)
+        FATAL_ERROR("error: failed to open \"%s\" for writing\n", mapFileName.c_str());
+
+    unsigned long totalPadding = 0;
+
+    std::fprintf(fp, "Memory map of %s (%s) from 0x%08lX\n\n", symFileName.c_str(), sectionName.c_str(), startAddress);
+    std::fprintf(fp, "Address     Size        Padding  Name\n");
+
+    for (const MapEntry& entry : s_map)
+    {
+        std::fprintf(fp, "0x%08lX  0x%08lX  %7lu  %s%s\n", entry.address, entry.size, entry.padding, entry.isSymbol ? "    " : "", entry.name.c_str());
+
+        if (!entry.isSymbol)
+            totalPadding += entry.padding;
+    }
+
+    // Alignment padding at the end is only known once the next fragment
+    // starts, but it still counts towards the total.
+    totalPadding += s_pendingPadding;
+
+    unsigned long totalSize = s_location - startAddress;
+
+    std::fprintf(fp, "\nTotal size 0x%lX (%lu) bytes, %lu bytes of padding (%.1f%%)\n",
+        totalSize, totalSize, totalPadding, totalSize ? 100.0 * totalPadding / totalSize : 0.0);
+
+    std::fclose(fp);
+}
+
 int main(int argc, char **argv)
 {
     if (argc < 4)
     {
-        fprintf(stderr, "Usage: %s SECTION_NAME SYM_FILE LANG [-c SRC_PATH,COMMON_SYM_PATH]", argv[0]);
+        fprintf(stderr,
+            "Usage: %s SECTION_NAME SYM_FILE LANG [-c SRC_PATH,COMMON_SYM_PATH[,LIB_PATH]]\n"
+            "       [-m MAP_FILE[,OBJ_PATH]] [-a START_ADDRESS] [-p]\n"
+            "\n"
+            "    -c  lay out COMMON symbols from the objects in SRC_PATH, in the\n"
+            "        order given by the files in COMMON_SYM_PATH\n"
+            "    -m  write a memory map of the fragment to MAP_FILE; mapping a\n"
+            "        section other than COMMON needs the objects in OBJ_PATH\n"
+            "    -a  address the fragment starts at, for exact padding (default 0)\n"
+            "    -p  reorder COMMON symbols within each object to reduce padding\n",
+            argv[0]);
         return 1;
     }
 
     bool common = false;
+    bool pack = false;
     std::string sectionName = std::string(argv[1]);
     std::string symFileName = std::string(argv[2]);
     std::string lang = std::string(argv[3]);
     std::string sourcePath;
     std::string commonSymPath;
-    std::string libSourcePath;
+    std::string libSourcePath = "tools/agbcc/lib";
+    std::string mapFileName;
+    std::string objectPath;
+    unsigned long startAddress = 0;
 
-    if (argc > 4)
+    for (int i = 4; i < argc; i++)
     {
-        if (std::strcmp(argv[4], "-c") != 0)
-            FATAL_ERROR("error: unrecognized argument \"%s\"\n", argv[4]);
+        if (std::strcmp(argv[i], "-c") == 0)
+        {
+            if (i + 1 >= argc)
+                FATAL_ERROR("error: missing SRC_PATH,COMMON_SYM_PATH after \"-c\"\n");
 
-        if (argc < 6)
-            FATAL_ERROR("error: missing SRC_PATH,COMMON_SYM_PATH after \"-c\"\n");
+            common = true;
+            std::string paths = std::string(argv[++i]);
+            std::size_t commaPos = paths.find(',');
 
-        common = true;
-        std::string paths = std::string(argv[5]);
-        std::size_t commaPos = paths.find(',');
+            if (commaPos == std::string::npos)
+                FATAL_ERROR("error: missing comma in argument after \"-c\"\n");
 
-        if (commaPos == std::string::npos)
-            FATAL_ERROR("error: missing comma in argument after \"-c\"\n");
+            sourcePath = paths.substr(0, commaPos);
+            commonSymPath = paths.substr(commaPos + 1);
+            commaPos = commonSymPath.find(',');
+            if (commaPos != std::string::npos) {
+                libSourcePath = commonSymPath.substr(commaPos + 1);
+                commonSymPath = commonSymPath.substr(0, commaPos);
+            }
+        }
+        else if (std::strcmp(argv[i], "-m") == 0)
+        {
+            if (i + 1 >= argc)
+                FATAL_ERROR("error: missing MAP_FILE after \"-m\"\n");
+
+            mapFileName = std::string(argv[++i]);
+            std::size_t commaPos = mapFileName.find(',');
+
+            if (commaPos != std::string::npos)
+            {
+                objectPath = mapFileName.substr(commaPos + 1);
+                mapFileName = mapFileName.substr(0, commaPos);
+            }
+        }
+        else if (std::strcmp(argv[i], "-a") == 0)
+        {
+            if (i + 1 >= argc)
+                FATAL_ERROR("error: missing START_ADDRESS after \"-a\"\n");
 
-        sourcePath = paths.substr(0, commaPos);
-        commonSymPath = paths.substr(commaPos + 1);
-        commaPos = commonSymPath.find(',');
-        if (commaPos == std::string::npos) {
-            libSourcePath = "tools/agbcc/lib";
-        } else {
-            libSourcePath = commonSymPath.substr(commaPos + 1);
-            commonSymPath = commonSymPath.substr(0, commaPos);
+            startAddress = std::strtoul(argv[++i], nullptr, 0);
+        }
+        else if (std::strcmp(argv[i], "-p") == 0)
+        {
+            pack = true;
+        }
+        else
+        {
+            FATAL_ERROR("error: unrecognized argument \"%s\"\n", argv[i]);
         }
     }
 
-    ConvertSymFile(symFileName, sectionName, lang, common, sourcePath, commonSymPath, libSourcePath);
+    bool map = !mapFileName.empty();
+
+    if (map && !common && objectPath.empty())
+        FATAL_ERROR("error: mapping %s needs OBJ_PATH after \"-m\"\n", sectionName.c_str());
+
+    if (pack && !common)
+        FATAL_ERROR("error: \"-p\" only applies to COMMON symbols\n");
+
+    s_location = startAddress;
+
+    ConvertSymFile(symFileName, sectionName, lang, common, sourcePath, commonSymPath, libSourcePath, map, objectPath, pack);
+
+    if (map)
+        WriteMemoryMap(mapFileName, symFileName, sectionName, startAddress);
+
     return 0;
 }